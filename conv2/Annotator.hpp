@@ -0,0 +1,183 @@
+/**
+ * @file	Annotator.hpp
+ * @author	radj307
+ * @brief	Finds values with units in free text (such as log lines) & converts them in place.
+ */
+#pragma once
+#include "OutputBuffer.hpp"
+#include "UnitTable.hpp"
+
+#include <make_exception.hpp>
+
+#include <format.hpp>
+
+#include <bit>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+	/**
+	 * @brief		Finds the first ASCII digit.
+	 * @returns		A pointer to the first digit, or end if there are none.
+	 */
+	inline const char* find_digit(const char* p, const char* const end) noexcept
+	{
+	#if defined(__AVX2__)
+		const __m256i lo{ _mm256_set1_epi8('0' - 1) }, hi{ _mm256_set1_epi8('9' + 1) };
+		for (; end - p >= 32; p += 32) {
+			const __m256i v{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) };
+			// bytes above 0x7F are negative, so the signed comparison excludes them
+			if (const unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v)))) }; mask != 0u)
+				return p + std::countr_zero(mask);
+		}
+	#elif defined(__SSE2__) || defined(_M_X64)
+		const __m128i lo{ _mm_set1_epi8('0' - 1) }, hi{ _mm_set1_epi8('9' + 1) };
+		for (; end - p >= 16; p += 16) {
+			const __m128i v{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+			// bytes above 0x7F are negative, so the signed comparison excludes them
+			if (const unsigned mask{ static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmpgt_epi8(hi, v)))) }; mask != 0u)
+				return p + std::countr_zero(mask);
+		}
+	#endif
+		for (; p != end; ++p)
+			if (*p >= '0' && *p <= '9')
+				return p;
+		return end;
+	}
+}
+
+/**
+ * @class	Annotator
+ * @brief	Scans free text for numbers followed by a known unit, & converts them to the target unit of the same quantity.
+ *\n		Each conversion is either appended after the original value, or replaces it. All other text is copied through unchanged.
+ */
+class Annotator {
+	/// @brief	The conversion applied to values in one unit.
+	struct Conversion {
+		conv::affine transform{ 1.0L, 0.0L };
+		// @brief	The index of the target unit in targets, or npos when no target was specified for the unit's quantity.
+		size_t target{ UnitTable::npos };
+	};
+
+	OutputBuffer& out;
+	conv::FloatFormat const& floatFormat;
+	bool replace;
+	std::string prefix, suffix;
+	UnitTable units;
+	// @brief	The conversion for each unit in units.
+	std::vector<Conversion> conversions;
+	// @brief	The target units, & the text they're printed with.
+	std::vector<std::pair<size_t, std::string>> targets;
+
+	static bool is_word(char const c) noexcept
+	{
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '.';
+	}
+	static bool is_letter(char const c) noexcept
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+	}
+
+public:
+	/**
+	 * @brief				Constructor.
+	 * @param out			The output buffer.
+	 * @param floatFormat	The format of converted values.
+	 * @param replace		When true, converted values replace the original values instead of being appended after them.
+	 * @param prefix		Text written before each converted value.
+	 * @param suffix		Text written after each converted value.
+	 */
+	Annotator(OutputBuffer& out, conv::FloatFormat const& floatFormat, bool const replace, std::string prefix, std::string suffix) : out{ out }, floatFormat{ floatFormat }, replace{ replace }, prefix{ std::move(prefix) }, suffix{ std::move(suffix) }
+	{
+		conversions.resize(units.size());
+	}
+
+	/**
+	 * @brief		Sets the unit that values of the same quantity are converted to. Only quantities with a target unit are converted.
+	 * @param name	The unit's symbol or name, exactly as it is printed.
+	 */
+	void addTarget(std::string const& name)
+	{
+		const size_t index{ units.find(name) };
+		if (index == UnitTable::npos)
+			throw make_exception("Unrecognized unit: \"", name, "\"!");
+		const UnitInfo& target{ units[index] };
+		for (const auto& [other, otherName] : targets)
+			if (units[other].dimension == target.dimension)
+				throw make_exception("Units \"", otherName, "\" & \"", name, "\" measure the same quantity; only one target unit can be specified for each!");
+		targets.emplace_back(index, name);
+
+		for (size_t i{ 0ull }; i < units.size(); ++i)
+			if (units[i].dimension == target.dimension)
+				conversions[i] = { units[i].to(target), targets.size() - 1ull };
+	}
+
+	/**
+	 * @brief		Processes a block of text. Values & their units must not be split between blocks, so blocks should end on line boundaries.
+	 * @param text	Input text.
+	 */
+	void process(std::string_view const text)
+	{
+		const char* const begin{ text.data() }, * const end{ begin + text.size() };
+		const char* span{ begin }; //< the start of the text that hasn't been written yet
+		for (const char* p{ detail::find_digit(begin, end) }; p != end; p = detail::find_digit(p, end)) {
+			// numbers must start at the beginning of a word
+			if (p != begin && is_word(p[-1])) {
+				while (p != end && is_word(*p))
+					++p;
+				continue;
+			}
+			const char* const first{ (p != begin && p[-1] == '-' && (p - 1 == begin || !is_word(p[-2]))) ? p - 1 : p };
+
+			// read the number
+			while (p != end && *p >= '0' && *p <= '9')
+				++p;
+			if (end - p >= 2 && *p == '.' && p[1] >= '0' && p[1] <= '9')
+				for (++p; p != end && *p >= '0' && *p <= '9'; ++p) {}
+			const char* const last{ p };
+
+			// read the unit, which may follow a space
+			const char* q{ p };
+			const bool spaced{ q != end && *q == ' ' };
+			if (spaced)
+				++q;
+			const char* const unitBegin{ q };
+			if (end - q >= 2 && q[0] == '\xC2' && q[1] == '\xB0') // degree sign
+				q += 2;
+			while (q != end && is_letter(*q))
+				++q;
+			// the unit must end the word; a period may follow it at the end of a sentence
+			if (q == unitBegin || (q != end && (*q == '/' || (is_word(*q) && !(*q == '.' && (q + 1 == end || !is_word(q[1])))))))
+				continue;
+
+			const size_t index{ units.find(std::string_view{ unitBegin, static_cast<size_t>(q - unitBegin) }) };
+			if (index == UnitTable::npos)
+				continue;
+			const Conversion& conversion{ conversions[index] };
+			if (conversion.target == UnitTable::npos || (spaced && !units[index].spaced) || (!replace && conversion.transform.scale == 1.0L && conversion.transform.offset == 0.0L))
+				continue;
+
+			double value;
+			if (std::from_chars(first, last, value).ec != std::errc{})
+				continue;
+			out.append(span, replace ? first : q);
+			out += prefix;
+			const double result{ conversion.transform(value) };
+			char* const buf{ out.prepare(64ull) };
+			if (const char* end{ conv::format(buf, buf + 64, result, floatFormat) }; end != nullptr)
+				out.commit(static_cast<size_t>(end - buf));
+			else out += conv::to_string(result, floatFormat);
+			out.push_back(' ');
+			out += targets[conversion.target].second;
+			out += suffix;
+			span = p = q;
+		}
+		out.append(span, end);
+	}
+};
@@ -0,0 +1,125 @@
+/**
+ * @file	AutoClassifier.hpp
+ * @author	radj307
+ * @brief	Classifies input tokens by the kind of value they contain, so that mixed inputs can be routed to the right converter in one pass.
+ */
+#pragma once
+#include "UnitTable.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+enum class TokenKind : unsigned char {
+	// @brief	Not recognized.
+	Unknown,
+	// @brief	A decimal number. ("12", "-4.5")
+	Number,
+	// @brief	A decimal number followed directly by a unit. ("12MB", "72F")
+	Measurement,
+	// @brief	A unit symbol or name. ("MB", "feet")
+	Unit,
+	// @brief	A hexadecimal integer literal. ("0x1F")
+	Hexadecimal,
+	// @brief	A binary integer literal. ("0b1010")
+	Binary,
+	// @brief	All or part of a bitwise expression. ("5&3", "(0xF0", "XOR")
+	Expression,
+};
+
+/**
+ * @struct	Token
+ * @brief	A classified token.
+ */
+struct Token {
+	TokenKind kind{ TokenKind::Unknown };
+	// @brief	The numeric part of Number & Measurement tokens, or the digits of Hexadecimal & Binary tokens.
+	std::string_view value;
+	// @brief	The index of the unit in the UnitTable, for Measurement & Unit tokens.
+	size_t unit{ UnitTable::npos };
+};
+
+/**
+ * @class	AutoClassifier
+ * @brief	Classifies tokens with a single scan of their characters.
+ */
+class AutoClassifier {
+	UnitTable const& units;
+
+	static bool is_digit(char const c) noexcept { return c >= '0' && c <= '9'; }
+	static bool is_operator(char const c) noexcept { return c == '&' || c == '|' || c == '^' || c == '~' || c == '(' || c == ')'; }
+
+	/// @brief	Returns true when the given string is a bitwise operator name.
+	static bool is_operator_word(std::string_view const s) noexcept
+	{
+		const auto& equals{ [&s](std::string_view const word) {
+			return s.size() == word.size() && std::equal(s.begin(), s.end(), word.begin(), [](char const l, char const r) { return (l | 0x20) == r; });
+		} };
+		return equals("and") || equals("or") || equals("xor") || equals("not");
+	}
+
+	/// @brief	Returns true when the given string is a non-empty run of digits in the given base.
+	static bool all_digits(std::string_view const s, int const base) noexcept
+	{
+		return !s.empty() && std::all_of(s.begin(), s.end(), [base](char const c) {
+			return base == 2 ? (c == '0' || c == '1') : (is_digit(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f'));
+		});
+	}
+
+public:
+	AutoClassifier(UnitTable const& units) : units{ units } {}
+
+	/// @brief	Returns true when the given token continues the bitwise expression before it.
+	static bool continues_expression(std::string_view const s) noexcept
+	{
+		// '~' & '(' are excluded because they begin an operand
+		return !s.empty() && ((is_operator(s.front()) && s.front() != '~' && s.front() != '(') || is_operator_word(s));
+	}
+	/// @brief	Returns true when the given expression needs another operand.
+	static bool expects_operand(std::string_view const s) noexcept
+	{
+		if (s.empty())
+			return false;
+		if (is_operator(s.back()) && s.back() != ')')
+			return true;
+		const size_t pos{ s.find_last_of(" \t") };
+		return is_operator_word(pos == std::string_view::npos ? s : s.substr(pos + 1ull));
+	}
+
+	/**
+	 * @brief		Classifies a token.
+	 * @param s		Input token.
+	 * @returns		Token
+	 */
+	Token operator()(std::string_view const s) const
+	{
+		if (s.empty())
+			return{};
+		if (is_operator_word(s) || std::any_of(s.begin(), s.end(), is_operator))
+			return{ TokenKind::Expression, s };
+
+		if (s.size() > 2ull && s[0] == '0') {
+			if ((s[1] | 0x20) == 'x' && all_digits(s.substr(2ull), 16))
+				return{ TokenKind::Hexadecimal, s.substr(2ull) };
+			if ((s[1] | 0x20) == 'b' && all_digits(s.substr(2ull), 2))
+				return{ TokenKind::Binary, s.substr(2ull) };
+		}
+
+		// the numeric part
+		size_t i{ (s[0] == '-' || s[0] == '+') ? 1ull : 0ull };
+		const size_t digitsBegin{ i };
+		while (i < s.size() && is_digit(s[i]))
+			++i;
+		if (i + 1ull < s.size() && s[i] == '.' && is_digit(s[i + 1ull]))
+			for (++i; i < s.size() && is_digit(s[i]); ++i) {}
+		if (i == digitsBegin) { // no digits
+			if (const size_t unit{ units.find(s) }; unit != UnitTable::npos)
+				return{ TokenKind::Unit, {}, unit };
+			return{};
+		}
+		if (i == s.size())
+			return{ TokenKind::Number, s };
+		if (const size_t unit{ units.find(s.substr(i)) }; unit != UnitTable::npos)
+			return{ TokenKind::Measurement, s.substr(0ull, i), unit };
+		return{};
+	}
+};
@@ -0,0 +1,64 @@
+/**
+ * @file	BinaryInput.hpp
+ * @author	radj307
+ * @brief	Decodes packed arrays of binary values; the reverse of the binary formats written by RecordWriter.
+ */
+#pragma once
+#include "RecordWriter.hpp"
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace detail {
+	/// @brief	Loads a little-endian value from an unaligned address. Compilers reduce this to a single load on little-endian targets.
+	template<typename T>
+	inline T load_le(const unsigned char* p) noexcept
+	{
+		using Bits = std::conditional_t<sizeof(T) == 8ull, std::uint64_t, std::uint32_t>;
+		Bits bits{ 0 };
+		for (size_t i{ 0ull }; i < sizeof(T); ++i)
+			bits |= static_cast<Bits>(p[i]) << (8ull * i);
+		return std::bit_cast<T>(bits);
+	}
+}
+
+/// @brief	Returns the size of one value in the given binary format, in bytes.
+inline constexpr size_t binary_value_size(RecordFormat const format) noexcept
+{
+	return format == RecordFormat::F32 ? 4ull : 8ull;
+}
+
+/**
+ * @brief			Decodes packed little-endian values.
+ * @param format	The binary format of the input; one of the binary RecordFormat values.
+ * @param in		Input bytes, which must contain at least (count * binary_value_size(format)) bytes.
+ * @param count		The number of values to decode.
+ * @param out		Output buffer, which must have room for count values. Use long double to keep 64-bit integers exact where it
+ *\n				 has a 64-bit mantissa; double rounds integers above 2^53.
+ */
+template<std::floating_point T>
+inline void decode_binary(RecordFormat const format, const unsigned char* in, size_t const count, T* out) noexcept
+{
+	const auto& decode{ [&]<typename U>(std::type_identity<U>) {
+		for (size_t i{ 0ull }; i < count; ++i, in += sizeof(U))
+			out[i] = static_cast<T>(detail::load_le<U>(in));
+	} };
+	switch (format) {
+	case RecordFormat::F64:
+		decode(std::type_identity<double>{});
+		break;
+	case RecordFormat::F32:
+		decode(std::type_identity<float>{});
+		break;
+	case RecordFormat::I64:
+		decode(std::type_identity<std::int64_t>{});
+		break;
+	case RecordFormat::U64:
+		decode(std::type_identity<std::uint64_t>{});
+		break;
+	default:
+		break;
+	}
+}
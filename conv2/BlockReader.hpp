@@ -0,0 +1,96 @@
+/**
+ * @file	BlockReader.hpp
+ * @author	radj307
+ * @brief	Reads whitespace-delimited input in large blocks, for modes that stream their input instead of collecting it.
+ */
+#pragma once
+#include <cstdio>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class	BlockReader
+ * @brief	Reads a file in large blocks that always end on a token boundary, so tokens never straddle two blocks.
+ *\n		In line mode, blocks end on line boundaries instead.
+ *\n		The view returned by next() is invalidated by the next call.
+ */
+class BlockReader {
+	std::FILE* file;
+	std::vector<char> buf;
+	// @brief	The position & length of the partial token that follows the most recently returned block.
+	size_t leftover{ 0ull }, leftoverLength{ 0ull };
+	bool eof{ false };
+	bool lines;
+
+	static bool is_space(char const c) noexcept { return std::isspace(static_cast<unsigned char>(c)) != 0; }
+	bool is_boundary(char const c) const noexcept { return lines ? c == '\n' : is_space(c); }
+
+public:
+	/**
+	 * @brief				Constructor.
+	 * @param file			The file to read from. Defaults to STDIN.
+	 * @param blockSize		The initial size of the read buffer. This is grown automatically if a single token is larger.
+	 * @param lines			When true, blocks end on line boundaries instead of on any whitespace.
+	 */
+	BlockReader(std::FILE* file = stdin, size_t const blockSize = 1ull << 20, bool const lines = false) : file{ file }, buf(blockSize), lines{ lines } {}
+
+	/**
+	 * @brief	Reads the next block of complete tokens.
+	 * @returns	A view of the block, or an empty view once all input has been consumed.
+	 */
+	std::string_view next()
+	{
+		// move the partial token from the previous block to the front of the buffer
+		size_t size{ leftoverLength };
+		if (leftoverLength != 0ull)
+			std::char_traits<char>::move(buf.data(), buf.data() + leftover, leftoverLength);
+		leftover = leftoverLength = 0ull;
+
+		while (!eof) {
+			if (size == buf.size()) // a single token filled the whole buffer
+				buf.resize(buf.size() * 2ull);
+
+			const size_t count{ std::fread(buf.data() + size, 1ull, buf.size() - size, file) };
+			eof = count < buf.size() - size;
+			size += count;
+
+			if (eof)
+				break;
+
+			// find the end of the last complete token
+			size_t end{ size };
+			while (end > 0ull && !is_boundary(buf[end - 1ull]))
+				--end;
+			if (end == 0ull) // no whitespace in the buffer yet; keep reading
+				continue;
+
+			leftover = end;
+			leftoverLength = size - end;
+			return{ buf.data(), end };
+		}
+		return{ buf.data(), size };
+	}
+};
+
+/**
+ * @brief		Calls a function for each whitespace-delimited token in the given string.
+ * @param s		Input string.
+ * @param fn	A function that accepts a std::string_view.
+ */
+template<typename TFunc>
+inline void for_each_token(std::string_view const s, TFunc&& fn)
+{
+	const char* p{ s.data() };
+	const char* const end{ p + s.size() };
+	while (p != end) {
+		while (p != end && std::isspace(static_cast<unsigned char>(*p)))
+			++p;
+		const char* const begin{ p };
+		while (p != end && !std::isspace(static_cast<unsigned char>(*p)))
+			++p;
+		if (p != begin)
+			fn(std::string_view{ begin, static_cast<size_t>(p - begin) });
+	}
+}
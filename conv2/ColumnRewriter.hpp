@@ -0,0 +1,195 @@
+/**
+ * @file	ColumnRewriter.hpp
+ * @author	radj307
+ * @brief	In-place conversion of one column of delimited text (CSV, TSV, etc.), for converting fields in large tables without splitting them apart first.
+ */
+#pragma once
+#include "OutputBuffer.hpp"
+
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+	/**
+	 * @brief		Finds the first occurrence of any of the given characters.
+	 * @returns		A pointer to the first match, or end if there are none.
+	 */
+	inline const char* find_any(const char* p, const char* const end, char const a, char const b, char const c) noexcept
+	{
+	#if defined(__AVX2__)
+		const __m256i va{ _mm256_set1_epi8(a) }, vb{ _mm256_set1_epi8(b) }, vc{ _mm256_set1_epi8(c) };
+		for (; end - p >= 32; p += 32) {
+			const __m256i v{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) };
+			if (const unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)), _mm256_cmpeq_epi8(v, vc)))) }; mask != 0u)
+				return p + std::countr_zero(mask);
+		}
+	#elif defined(__SSE2__) || defined(_M_X64)
+		const __m128i va{ _mm_set1_epi8(a) }, vb{ _mm_set1_epi8(b) }, vc{ _mm_set1_epi8(c) };
+		for (; end - p >= 16; p += 16) {
+			const __m128i v{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) };
+			if (const unsigned mask{ static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc)))) }; mask != 0u)
+				return p + std::countr_zero(mask);
+		}
+	#endif
+		for (; p != end; ++p)
+			if (*p == a || *p == b || *p == c)
+				return p;
+		return end;
+	}
+}
+
+/**
+ * @class	ColumnRewriter
+ * @brief	Streams delimited text to an OutputBuffer, replacing the values in one column & copying every other byte through unchanged.
+ *\n		Quoted fields (RFC 4180) may contain delimiters, quotes, & line breaks. Input can be fed in blocks of any size.
+ *\n		Fields in the target column that aren't numbers, such as the header, are copied through unchanged.
+ */
+class ColumnRewriter {
+	OutputBuffer& out;
+	char delimiter;
+	// @brief	The index of the target column, or npos until a column specified by name is found in the header.
+	size_t column;
+	std::string name;
+	size_t field{ 0ull }, record{ 0ull };
+	bool inQuotes{ false };
+	// @brief	When true, the current field is withheld from the output until it is complete so it can be converted.
+	bool withholding{ false };
+	// @brief	When true, the current field is collected in target.
+	bool capturing{ false };
+	std::string target;
+
+	void start_field()
+	{
+		target.clear();
+		withholding = field == column;
+		capturing = withholding || (record == 0ull && column == std::string::npos);
+	}
+
+	/// @brief	Writes a withheld field, converting it when it is a number. Surrounding whitespace & quotes are preserved.
+	template<typename TFunc>
+	void write_field(TFunc&& convert)
+	{
+		const std::string_view s{ target };
+		const size_t first{ s.find_first_not_of(" \t\r") };
+		if (first == std::string_view::npos) {
+			out.append(s);
+			return;
+		}
+		const size_t last{ s.find_last_not_of(" \t\r") + 1ull };
+		const std::string_view value{ s.substr(first, last - first) };
+		// numbers never contain quotes, so quoted values don't need to be unescaped
+		const bool quoted{ value.size() >= 2ull && value.front() == '"' && value.back() == '"' };
+
+		out.append(s.substr(0ull, first));
+		if (quoted)
+			out.push_back('"');
+		if (convert(quoted ? value.substr(1ull, value.size() - 2ull) : value)) {
+			if (quoted)
+				out.push_back('"');
+		}
+		else out.append(quoted ? value.substr(1ull) : value);
+		out.append(s.substr(last));
+	}
+
+	template<typename TFunc>
+	void end_field(TFunc&& convert)
+	{
+		if (record == 0ull && column == std::string::npos) {
+			std::string_view header{ target };
+			if (header.size() >= 2ull && header.front() == '"' && header.back() == '"')
+				header = header.substr(1ull, header.size() - 2ull);
+			if (header == name)
+				column = field;
+		}
+		if (withholding)
+			write_field(std::forward<TFunc>(convert));
+	}
+
+	void end_record()
+	{
+		if (record == 0ull && column == std::string::npos)
+			throw make_exception("The header doesn't contain a column named \"", name, "\"!");
+		field = 0ull;
+		++record;
+	}
+
+public:
+	/**
+	 * @brief				Constructor.
+	 * @param out			The output buffer.
+	 * @param delimiter		The field delimiter.
+	 * @param column		The target column; either a 1-based column number, or the name of a column in the header.
+	 */
+	ColumnRewriter(OutputBuffer& out, char const delimiter, std::string_view const column) : out{ out }, delimiter{ delimiter }, column{ std::string::npos }
+	{
+		if (!column.empty() && std::all_of(column.begin(), column.end(), [](char const c) { return c >= '0' && c <= '9'; })) {
+			this->column = static_cast<size_t>(std::stoull(std::string{ column }));
+			if (this->column-- == 0ull)
+				throw make_exception("Column numbers start at 1!");
+		}
+		else name = column;
+		start_field();
+	}
+
+	/**
+	 * @brief			Processes the next block of input.
+	 * @param block		Input text.
+	 * @param convert	A function that accepts the std::string_view text of a field in the target column. If it is a number, it should
+	 *\n				 write the converted value to the output buffer & return true; otherwise, it should return false without writing anything.
+	 */
+	template<typename TFunc>
+	void feed(std::string_view const block, TFunc&& convert)
+	{
+		const char* p{ block.data() }, * const end{ p + block.size() };
+		const char* span{ p }; //< the start of the bytes that are copied through unchanged
+		while (true) {
+			const char* const q{ inQuotes ? std::find(p, end, '"') : detail::find_any(p, end, delimiter, '"', '\n') };
+			if (capturing)
+				target.append(p, q);
+			if (q == end)
+				break;
+			p = q + 1;
+
+			if (*q == '"') { // doubled quotes inside a quoted field toggle the state twice, so they need no special handling
+				inQuotes = !inQuotes;
+				if (capturing)
+					target.push_back('"');
+				continue;
+			}
+
+			// an unquoted delimiter or line break ends the field
+			end_field(convert);
+			if (withholding)
+				span = q; //< the delimiter itself is copied through
+			if (*q == '\n')
+				end_record();
+			else ++field;
+			start_field();
+			if (withholding) {
+				out.append(span, p);
+				span = p;
+			}
+		}
+		if (!withholding)
+			out.append(span, end);
+	}
+
+	/// @brief	Ends the input, writing the last field if it was withheld.
+	template<typename TFunc>
+	void finish(TFunc&& convert)
+	{
+		if (field == 0ull && target.empty() && !withholding) // the input ended with a line break
+			return;
+		end_field(convert);
+		end_record();
+		start_field();
+	}
+};
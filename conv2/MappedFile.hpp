@@ -0,0 +1,103 @@
+/**
+ * @file	MappedFile.hpp
+ * @author	radj307
+ * @brief	Read-only memory mapping of whole files, for modes that process large files without copying them.
+ */
+#pragma once
+#include <make_exception.hpp>
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class	MappedFile
+ * @brief	Maps an entire file into memory for reading.
+ *\n		Files that cannot be mapped (pipes, character devices, etc.) are opened successfully, but is_mapped() returns false;
+ *\n		 callers should fall back to reading them as a stream.
+ */
+class MappedFile {
+	const unsigned char* ptr{ nullptr };
+	size_t len{ 0ull };
+	bool mapped{ false };
+
+#ifdef _WIN32
+	HANDLE file{ INVALID_HANDLE_VALUE }, mapping{ nullptr };
+#endif
+
+public:
+	/**
+	 * @brief		Opens & maps the specified file.
+	 * @param path	The path to the file.
+	 */
+	MappedFile(std::string const& path)
+	{
+	#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw make_exception("Failed to open file \"", path, "\"!");
+		LARGE_INTEGER size;
+		if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size))
+			return;
+		len = static_cast<size_t>(size.QuadPart);
+		mapped = true;
+		if (len == 0ull)
+			return;
+		if ((mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) == nullptr
+			|| (ptr = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))) == nullptr)
+			mapped = false;
+	#else
+		const int fd{ ::open(path.c_str(), O_RDONLY) };
+		if (fd == -1)
+			throw make_exception("Failed to open file \"", path, "\"!");
+		struct stat st;
+		if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+			len = static_cast<size_t>(st.st_size);
+			mapped = true;
+			if (len != 0ull) {
+				if (void* p{ ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0) }; p != MAP_FAILED) {
+					ptr = static_cast<const unsigned char*>(p);
+					::madvise(p, len, MADV_SEQUENTIAL);
+				}
+				else mapped = false;
+			}
+		}
+		::close(fd); // the mapping remains valid after the descriptor is closed
+	#endif
+	}
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+	~MappedFile()
+	{
+	#ifdef _WIN32
+		if (ptr != nullptr)
+			UnmapViewOfFile(ptr);
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+	#else
+		if (ptr != nullptr)
+			::munmap(const_cast<unsigned char*>(ptr), len);
+	#endif
+	}
+
+	/// @brief	Returns true when the file's contents are available through data() & size().
+	bool is_mapped() const noexcept { return mapped; }
+	const unsigned char* data() const noexcept { return ptr; }
+	size_t size() const noexcept { return len; }
+};
@@ -0,0 +1,384 @@
+/**
+ * @file	Modes.hpp
+ * @author	radj307
+ * @brief	The mode registry; describes every mode & how to select it, & declares the function that runs each one.
+ */
+#pragma once
+#include "OutputBuffer.hpp"
+#include "RecordWriter.hpp"
+
+#include <opt3.hpp>
+
+#include <affine.hpp>
+#include <format.hpp>
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class ModeID : unsigned char {
+	Data,
+	Hex,
+	Base,
+	Modulo,
+	Length,
+	ASCII,
+	Radians,
+	FOV,
+	Bitwise,
+	Exponent,
+	Temperature,
+	Auto,
+	Annotate,
+	Unit,
+	Time,
+};
+
+/**
+ * @struct	ModeRunner
+ * @brief	The state shared by every mode. Each mode is a specialization of run(), compiled in its own translation unit.
+ */
+struct ModeRunner {
+	opt3::ArgManager& args;
+	// @brief	Inputs from the commandline, & from STDIN when the mode doesn't read it itself.
+	std::vector<std::string> const& parameters;
+	std::ostream& buffer;
+	OutputBuffer& sink;
+	RecordWriter& records;
+	conv::FloatFormat const& floatFormat;
+	bool quiet;
+	// @brief	When true, STDIN has input that hasn't been read yet.
+	bool pendingInput;
+	// @brief	Set to false by modes whose output shouldn't end with an extra newline.
+	bool& trailingNewline;
+
+	template<ModeID ID> void run();
+};
+template<> void ModeRunner::run<ModeID::Data>();
+template<> void ModeRunner::run<ModeID::Hex>();
+template<> void ModeRunner::run<ModeID::Base>();
+template<> void ModeRunner::run<ModeID::Modulo>();
+template<> void ModeRunner::run<ModeID::Length>();
+template<> void ModeRunner::run<ModeID::ASCII>();
+template<> void ModeRunner::run<ModeID::Radians>();
+template<> void ModeRunner::run<ModeID::FOV>();
+template<> void ModeRunner::run<ModeID::Bitwise>();
+template<> void ModeRunner::run<ModeID::Exponent>();
+template<> void ModeRunner::run<ModeID::Temperature>();
+template<> void ModeRunner::run<ModeID::Auto>();
+template<> void ModeRunner::run<ModeID::Annotate>();
+template<> void ModeRunner::run<ModeID::Unit>();
+template<> void ModeRunner::run<ModeID::Time>();
+
+/**
+ * @struct	UnitPair
+ * @brief	The conversion between the input & output units given to --range, --binary-in, or --column.
+ */
+struct UnitPair {
+	conv::affine transform{ 1.0L, 0.0L };
+	// @brief	The unit names written in records.
+	std::string inName, outName;
+	// @brief	The text written after input & output values.
+	std::string inUnit, outUnit;
+};
+
+/**
+ * @brief		Resolves the input & output units of a mode that supports --range, --binary-in, & --column.
+ *\n			Each specialization is defined in the same translation unit as the mode's run().
+ * @param in	The input unit.
+ * @param out	The output unit.
+ * @returns		UnitPair
+ */
+template<ModeID ID> UnitPair resolve_units(std::string const& in, std::string const& out);
+template<> UnitPair resolve_units<ModeID::Data>(std::string const&, std::string const&);
+template<> UnitPair resolve_units<ModeID::Length>(std::string const&, std::string const&);
+template<> UnitPair resolve_units<ModeID::Radians>(std::string const&, std::string const&);
+template<> UnitPair resolve_units<ModeID::Temperature>(std::string const&, std::string const&);
+template<> UnitPair resolve_units<ModeID::Unit>(std::string const&, std::string const&);
+template<> UnitPair resolve_units<ModeID::Time>(std::string const&, std::string const&);
+
+/**
+ * @struct	ModeDescriptor
+ * @brief	Describes a mode, which is selected when the first argument is one of its flags or options.
+ */
+struct ModeDescriptor {
+	ModeID id;
+	// @brief	The mode's flag, or '\0' when it doesn't have one.
+	char flag;
+	// @brief	The mode's option names. Unused names are empty.
+	std::array<std::string_view, 3ull> names;
+	// @brief	When true, the mode reads STDIN itself instead of receiving it as parameters.
+	bool streaming;
+	// @brief	The mode's description in the help display. Modes without one aren't listed, & have no scoped help.
+	std::string_view help;
+	// @brief	The rest of the mode's scoped help display ("--help <MODE>"), which follows its description.
+	std::string_view usage;
+	void (ModeRunner::*run)();
+	// @brief	Resolves the units given to --range, --binary-in, & --column, or nullptr when the mode doesn't support them.
+	UnitPair (*resolve)(std::string const&, std::string const&);
+};
+
+inline constexpr std::array MODES{
+	ModeDescriptor{ ModeID::Data, 'd', { "data" }, false,
+		"  -d, --data              Data Size Conversions. (B, kB, MB, GB, etc.)\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-d|--data> <<INPUT_UNIT> <VALUE> <OUTPUT_UNIT>>...\n"
+		"                    <<VALUE> <INPUT_UNIT> <OUTPUT_UNIT>>...\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"\n"
+		"  Units can be specified with their symbol (ex: B, kB, MB, etc.) or full names (ex: byte, kilobyte, megabyte, etc.).\n"
+		"  Unit symbols are case-sensitive while full names are case-insensitive.\n",
+		&ModeRunner::run<ModeID::Data>, &resolve_units<ModeID::Data> },
+	ModeDescriptor{ ModeID::Hex, 'x', { "hex", "hexadecimal" }, false,
+		"  -x, --hex               Hexadecimal <=> Decimal Conversions.\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-x|--hex> <VALUE>...\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"  All decimal inputs are converted to hexadecimal, and vice-versa.\n"
+		"\n"
+		"  Inputs are treated as hexadecimal if any of the following is true:\n"
+		"    - It contains at least one alphabetic character in the range [A - F]. (case-insensitive)\n"
+		"    - It is prefixed by \"0x\".\n"
+		"  If neither of the above are true for an input, it is assumed to be in base-10.\n",
+		&ModeRunner::run<ModeID::Hex>, nullptr },
+	// TODO: "  -B, --base              Number representation base conversions. (Binary, Octal, Decimal, Hexadecimal)\n"
+	ModeDescriptor{ ModeID::Base, 'B', { "base" }, false,
+		"",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-B|--base> < <<BASE>:<INPUT>> <BASE> >\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n",
+		&ModeRunner::run<ModeID::Base>, nullptr },
+	ModeDescriptor{ ModeID::Modulo, 'm', { "mod", "modulo" }, false,
+		"  -m, --mod               Modulo Calculator.\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-m|--mod> <<NUMBER> <MOD>>...\n"
+		"                   <<NUMBER>%<MOD>>...\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"  Inputs can either be in the format \"<NUMBER> <MOD>\" or without spaces as \"<NUMBER>%<MOD>\".\n"
+		"  If <NUMBER> is a power (\"<BASE>^<EXPONENT>\"), the result is calculated with modular exponentiation,\n"
+		"   which never calculates the full power. Ex: \"3^1000000%1000000007\"\n"
+		"\n"
+		"MODIFIERS:\n"
+		"      --mod-by <MOD>      Batch mode; calculate <NUMBER> % <MOD> for every input, using the same <MOD>.\n"
+		"                           Input is streamed from STDIN in blocks, so it can be arbitrarily large.\n"
+		"  -x  --hex               Treat every <NUMBER> as hexadecimal when used with \"--mod-by\".\n"
+		"\n"
+		"  Integer inputs may be arbitrarily long, & are treated as hexadecimal when they are prefixed with \"0x\"\n"
+		"   or contain a letter in the range [A - F]. Ex: \"conv2 -m --mod-by 64 < sha256-digests.txt\"\n",
+		&ModeRunner::run<ModeID::Modulo>, nullptr },
+	ModeDescriptor{ ModeID::Length, 'l', { "len", "length" }, false,
+		"  -l, --len               Length Unit Conversions. (meters, feet, Bethesda-units, etc.)\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-l|--len> [--exact] <<INPUT_UNIT> <VALUE> <OUTPUT_UNIT>>...\n"
+		"                             <<VALUE> <INPUT_UNIT> <OUTPUT_UNIT>>...\n"
+		"\n"
+		"MODIFIERS:\n"
+		"      --exact             Convert with exact fractions instead of floating-point numbers, so that the result is only\n"
+		"                           rounded once when it is printed. --precision is the number of significant digits, or the\n"
+		"                           number of decimal places with --fixed; --shortest prints every digit, up to 40 places.\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"  Each conversion always uses 3 parameters, so the total number of parameters must be a multiple of 3.\n"
+		"\n"
+		"  Units can be specified with their symbol (ex: ft, m, Mm, etc.) or full names (ex: feet/foot, meter, megameter, etc.).\n"
+		"  Unit symbols are case-sensitive while full names are case-insensitive.\n"
+		"  Both the American spelling \"meter\" and the British spelling \"metre\" are accepted.\n",
+		&ModeRunner::run<ModeID::Length>, &resolve_units<ModeID::Length> },
+	ModeDescriptor{ ModeID::ASCII, 'a', { "asc", "ascii" }, false,
+		"  -a, --ascii             ASCII Table Lookup Tool. Converts all characters to their ASCII values.\n",
+		"\n"
+		"MODIFIERS:\n"
+		"  -N  --numeric           Force parameters that are entirely composed of digits to be\n"
+		"                           converted to their numerical ASCII values.\n"
+		"  -s  --signed            Use signed range [-127 - 127] instead of unsigned range [0 - 255]\n"
+		"                           when interpreting input values and printing output values.\n"
+		"      --linear            Print each conversion on a new line instead of using the table-style output.\n"
+		"  -U  --utf8              Decode input as UTF-8 & print Unicode code points instead of byte values.\n"
+		"                           Numeric parameters are encoded from code points back into UTF-8.\n"
+		"      --file <PATH>       Dump the value of every byte (or code point, with -U) in a file. Use \"-\" to read from STDIN.\n"
+		"  -x  --hex               Print byte values & code points in hexadecimal.\n"
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-a|--ascii> [-N|--numeric] [-u|--unsigned] [--linear] <INPUT>...\n"
+		"  conv2 <-a|--ascii> [-s|--signed] [-U|--utf8] [-x|--hex] [--linear] --file <PATH>\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"\n"
+		"  By default, all inputs are converted to their numerical ASCII values -- including numbers.\n"
+		"  This behavior can be disabled with the \"--output-text\" modifier which changes this behavior\n"
+		"  so that any entirely-numerical parameters in the range [-127 - 255] are\n"
+		"  converted to their textual representations.\n",
+		&ModeRunner::run<ModeID::ASCII>, nullptr },
+	ModeDescriptor{ ModeID::Radians, 'R', { "rad", "radian", "radians" }, false,
+		"  -R, --rad               Degrees <=> Radians Converter.\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-R|--rad> <<NUMBER>[c]>...\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"\n"
+		"  Inputs are assumed to be in Degrees unless the letter 'c' or 'r' is appended to them.\n",
+		&ModeRunner::run<ModeID::Radians>, &resolve_units<ModeID::Radians> },
+	ModeDescriptor{ ModeID::FOV, 'F', { "FOV" }, false,
+		"  -F, --FOV <H:V>         Horizontal <=> Vertical Field of View Converter. Requires an aspect ratio, ex: \"16:9\".\n",
+		"\n"
+		"MODIFIERS:\n"
+		"  -R  --rad               Use radians instead of degrees for input and output values.\n"
+		"  -r  --round             Rounds the resulting output to the nearest integer.\n"
+		"      --sweep <RANGE>     Print a table of conversions for every value in the range \"start:stop[:step]\",\n"
+		"                           for every aspect ratio. Append 'V' to the range to sweep vertical FOV values.\n"
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-F|--FOV> <<AspectHorizontal>:<AspectVertical>> <<INPUT>[H|V] ...>\n"
+		"  conv2 <-F|--FOV> <<H>:<V>[,<H>:<V>...]> --sweep <START>:<STOP>[:<STEP>][H|V] [<H>:<V> ...]\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"\n"
+		"  Inputs may have an orientation specifier; either a 'V' for Vertical or 'H' for Horizontal.\n"
+		"  You can append the orientation specifier character to the number.\n"
+		"  If no orientation is specified, Horizontal is used by default.\n",
+		&ModeRunner::run<ModeID::FOV>, nullptr },
+	ModeDescriptor{ ModeID::Bitwise, 'b', { "bitwise" }, false,
+		"  -b, --bitwise           Perform bitwise calculations on binary, decimal, and/or hexadecimal numbers.\n",
+		"\n"
+		"MODIFIERS:\n"
+		"      --binary            Print output values in binary (base-2) instead of decimal.\n"
+		"  -O  --octal             Print numbers in octal (base-8) instead of decimal.\n"
+		"  -x  --hex               Print numbers in hexadecimal (base-16) instead of decimal.\n"
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-b|--bitwise> [MODIFIER] '<NUMBER> <OPERATOR> <NUMBER>'\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"  Note that bitwise expressions must be delimited with a comma (,) or semicolon (;) when using multiple\n"
+		"   expressions in the same command.\n"
+		"  Nesting operations is fully supported, you can use parenthesis '()' to control order-of-operations.\n"
+		"\n"
+		"BITWISE SYNTAX:\n"
+		"  Most operations are composed of two input values (operands) and an operator. The only exception to this rule is\n"
+		"   the 'NOT'/'~' operator, which requires only one operand.\n"
+		"  Each expression is composed of an operator, and two input values; Input values are assumed to be represented\n"
+		"   in base-10 (decimal), unless prefixed with '0b' for base-2 (binary), or '0x' for base-16 (hexadecimal).\n"
+		"  Example of the base-10 representation of `60` in binary and hex, using their respective prefixes:\n"
+		"\n"
+		"       `0b111100`\n"
+		"       `0x3C`\n"
+		"\n"
+		"  The operator may be specified using literal operator names ( 'AND', 'OR', 'XOR', 'NOT' ), or the\n"
+		"   standard symbols ( | ^ & ~ ). Most symbols must be escaped when used directly in the shell.\n"
+		"  This behavior is designed to support shell pipe operators, for example by using the `cat`\n"
+		"   or `echo` commands in combination with the '|' pipe operator like so:\n"
+		"\n"
+		"       `cat \"file\" | conv2 -bx`\n",
+		&ModeRunner::run<ModeID::Bitwise>, nullptr },
+	ModeDescriptor{ ModeID::Exponent, 'e', { "exp", "pow" }, true,
+		"  -e, --exp, --pow        Exponent Calculator.  Use a comma ',' (shell) or semicolon ';' (string) between expressions.\n",
+		"\n"
+		"USAGE:\n"
+		"  Any uncaptured commandline parameters are used as input.\n"
+		"  Note that each successive expression must be seperated from the previous expression with a comma (,) when used\n"
+		"   directly from the shell, or a semicolon (;) when enclosed by quotes (in most shells).\n"
+		"  Nesting operations is fully supported, you can use parenthesis '()' to control order-of-operations.\n"
+		"\n"
+		"EXPONENT SYNTAX:\n"
+		"  Use a caret symbol (^) to seperate the exponent from the variable.\n"
+		"  Seperate multiple expressions with a comma (,) or semicolon (;).\n"
+		"  To calculate the expression '5 to the power of 25 to the power of 2.', you would use:\n"
+		"    5 ^ (25 ^ 2)\n"
+		"  The caret operator is right-associative, so the brackets in the above example are optional.\n"
+		"  Use a percent symbol (%) to calculate the remainder of the result; \"<BASE> ^ <EXPONENT> % <MOD>\" uses\n"
+		"   modular exponentiation, so it works even when the full power would be enormous.\n"
+		"  Integer results are exact; floating-point operands produce floating-point results.\n",
+		&ModeRunner::run<ModeID::Exponent>, nullptr },
+	ModeDescriptor{ ModeID::Temperature, 't', { "temp", "temperature" }, true,
+		"  -t, --temp              Temperature Converter. Converts between Celcius, Kelvin, & Fahrenheit.\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-t|--temp>  <<<VALUE><INPUT_UNIT> <OUTPUT_UNIT>> ...>\n"
+		"  Any uncaptured commandline parameters are used as input, as is any data piped into STDIN.\n"
+		"  Input temperatures may be written as one word (\"100C\", \"C-40\") or two (\"100 C\", \"C -40\").\n",
+		&ModeRunner::run<ModeID::Temperature>, &resolve_units<ModeID::Temperature> },
+	ModeDescriptor{ ModeID::Unit, 'u', { "unit" }, false,
+		"  -u, --unit              Unit Converter for lengths, data sizes, temperatures, mass, volume, time, pressure, energy,\n"
+		"                           & compound units. (km/h, MiB/s, ft*lbf) Units accept SI prefixes (km, ms, kPa) & data\n"
+		"                           sizes accept binary prefixes. (KiB, MB)\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 <-u|--unit> <<VALUE>[ ]<INPUT_UNIT> <OUTPUT_UNIT>>...\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input, as is any data piped into STDIN.\n"
+		"  Units can be specified with their symbol (ex: km, MiB, °F, kPa) or full names (ex: kilometers, mebibytes).\n"
+		"  Unit symbols are case-sensitive while full names are case-insensitive. Symbols of data sizes (B, kB, KiB) may be\n"
+		"  written in any case, & their prefixes are powers of 1024; bits (bit, Mbit, Gbit) use powers of 1000.\n"
+		"  The input & output units must have the same dimension. (ex: \"5 kg lb\", \"72°F C\", \"3.5GiB MB\", \"90 min h\")\n"
+		"\n"
+		"  Compound units multiply units with '*' & divide them with '/', & may raise them to a power with '^'.\n"
+		"  (ex: \"100 km/h mph\", \"40 MiB/s Gbit/s\", \"12 ft*lbf J\", \"9.8 m/s^2 ft/s^2\")\n",
+		&ModeRunner::run<ModeID::Unit>, &resolve_units<ModeID::Unit> },
+	ModeDescriptor{ ModeID::Time, '\0', { "time" }, true,
+		"      --time              Duration Converter. (ns, us, ms, s, m, h, d, w) Accepts compound durations, ex: \"1h23m4.5s\".\n",
+		"\n"
+		"USAGE:\n"
+		"  conv2 --time <<DURATION>... [OUTPUT_UNIT]>...\n"
+		"\n"
+		"  Any uncaptured commandline parameters are used as input, as is any data piped into STDIN.\n"
+		"  Durations are numbers followed directly by a unit, & may combine several units. (ex: \"250ms\", \"1h23m4.5s\")\n"
+		"  Units: ns, us (µs), ms, s (sec), m (min), h (hr), d, & w.\n"
+		"  Each duration is converted to the next output unit after it, or written in compound form (ex: \"5004.5s\" => \"1h23m24.5s\")\n"
+		"   when no output unit follows it. Durations from STDIN are converted to the last output unit on the commandline.\n"
+		"  Durations are counted in whole nanoseconds, so conversions between units are exact.\n",
+		&ModeRunner::run<ModeID::Time>, &resolve_units<ModeID::Time> },
+	ModeDescriptor{ ModeID::Auto, '\0', { "auto" }, false,
+		"      --auto              Detect the kind of each input & convert it accordingly. Accepts measurements in any unit\n"
+		"                           that -u accepts (\"<VALUE>[ ]<UNIT> <OUTPUT_UNIT>\"), hex (0x) & binary (0b) literals,\n"
+		"                           & bitwise expressions, mixed together in any order.\n",
+		"",
+		&ModeRunner::run<ModeID::Auto>, nullptr },
+	ModeDescriptor{ ModeID::Annotate, '\0', { "annotate" }, true,
+		"      --annotate <UNIT>.. Find measurements in text from STDIN (or \"--file <PATH>\") & append\n"
+		"                           each one's value in the given unit of the same quantity, ex: \"--annotate MiB km C\".\n"
+		"                           Everything else is copied through unchanged. Use \"--replace\" to replace the values instead.\n",
+		"",
+		&ModeRunner::run<ModeID::Annotate>, nullptr },
+};
+
+/**
+ * @brief		Finds the mode selected by the given commandline argument.
+ * @param arg	The first commandline argument, ex: "-d", "-dq", "--data".
+ * @returns		A pointer to the mode's descriptor, or nullptr when the argument doesn't select a mode.
+ */
+inline const ModeDescriptor* find_mode(std::string_view const arg)
+{
+	static const auto& index{ []() {
+		std::unordered_map<std::string, const ModeDescriptor*> map;
+		for (const auto& mode : MODES) {
+			if (mode.flag != '\0')
+				map.emplace(std::string{ '-', mode.flag }, &mode);
+			for (const auto& name : mode.names)
+				if (!name.empty())
+					map.emplace(std::string{ "--" }.append(name), &mode);
+		}
+		return map;
+	}() };
+
+	std::string key;
+	if (arg.starts_with("--"))
+		key = arg.substr(0ull, arg.find('='));
+	else if (arg.size() >= 2ull && arg[0] == '-' && !(arg[1] >= '0' && arg[1] <= '9') && arg[1] != '.') // flags may be combined; negative numbers aren't flags
+		key = arg.substr(0ull, 2ull);
+	else return nullptr;
+
+	const auto& it{ index.find(key) };
+	return it == index.end() ? nullptr : it->second;
+}
@@ -0,0 +1,342 @@
+/**
+ * @file	NumericModes.cpp
+ * @author	radj307
+ * @brief	Number modes; hexadecimal, bases, modulo, bitwise, & exponents.
+ */
+#include "Modes.hpp"
+#include "BlockReader.hpp"
+#include "operators.hpp"
+
+#include <make_exception.hpp>
+#include <str.hpp>
+
+#include <base.hpp>
+#include <modulo.hpp>
+#include <bitwise.hpp>
+#include <exponents.hpp>
+#include <format.hpp>
+
+#include <charconv>
+#include <concepts>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// HEX
+template<> void ModeRunner::run<ModeID::Hex>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		records.header({ "input", "output" });
+	for (const auto& it : parameters) {
+		if (records.enabled()) {
+			records.number(it);
+			switch (base::detectBase(it, Base::DECIMAL | Base::HEXADECIMAL)) {
+			case Base::DECIMAL:
+				records.field(str::stringify("0x", str::fromBase10(it, 16)));
+				break;
+			case Base::HEXADECIMAL:
+				records.field(str::toBase10(it, 16));
+				break;
+			case Base::ZERO: [[fallthrough]];
+			default:
+				throw make_exception("Invalid number: \"", it, "\"!");
+			}
+			records.end();
+			continue;
+		}
+		if (!quiet)
+			buffer << color(OUTCOLOR::INPUT) << it << color() << color.equals();
+		switch (base::detectBase(it, Base::DECIMAL | Base::HEXADECIMAL)) {
+		case Base::DECIMAL:
+			buffer << color(OUTCOLOR::OUTPUT) << "0x" << str::fromBase10(it, 16) << color() << '\n';
+			break;
+		case Base::HEXADECIMAL:
+			buffer << color(OUTCOLOR::OUTPUT) << str::toBase10(it, 16) << color() << '\n';
+			break;
+		case Base::ZERO: [[fallthrough]];
+		default:
+			throw make_exception("Invalid number: \"", it, "\"!");
+		}
+	}
+}
+
+// BASE
+template<> void ModeRunner::run<ModeID::Base>()
+{
+	const auto& splitArg{ [](const std::string& str) -> std::pair<int, std::string> {
+		int base{ 10 };
+		std::string value{ 0ll };
+		if (const auto& pos{ str.find(':') }; pos != std::string::npos) {
+			base = str::stoi(str.substr(0ull, pos));
+			value = str.substr(pos + 1ull);
+		}
+		else value = str;
+		return{ base, value };
+	} };
+
+	std::pair<int, std::string> in;
+	int outBase{ 10 };
+	// TODO: Finish base conversion mode
+	const auto& calculate{ [&in, &outBase]() {
+
+	} };
+
+	for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
+
+	}
+}
+
+// MODULO
+template<> void ModeRunner::run<ModeID::Modulo>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		records.header({ "input", "divisor", "result" });
+	// Constant divisor batch mode:
+	if (const auto& modBy{ args.getv<opt3::Option>("mod-by") }; modBy.has_value()) {
+		const std::string& divisorStr{ modBy.value() };
+		const bool floatDivisor{ divisorStr.find('.') != std::string::npos };
+		const bool forceHex{ args.check_any<opt3::Flag, opt3::Option>('x', "hex") };
+		const modulo::Divisor divisor{ floatDivisor ? 1ll : str::stoll(divisorStr) };
+		const modulo::Barrett reducer{ divisor.d }; //< for inputs that are too large for IntT
+		constexpr size_t BLOCK_SIZE{ 4096ull };
+
+		// the parts of each line that never change
+		const std::string lineBegin{ quiet ? "" : std::string{ color(OUTCOLOR::INPUT) } };
+		const std::string lineMiddle{ quiet ? std::string{ color(OUTCOLOR::OUTPUT) } : color.span(color(), ' ', color(OUTCOLOR::OPERATOR), '%', color(), ' ', color(OUTCOLOR::INPUT), divisorStr, color(), color.equals(), color(OUTCOLOR::OUTPUT)) };
+		const std::string lineEnd{ color.span(color(), '\n') };
+
+		auto& out{ sink };
+		std::vector<modulo::IntT> values;
+		std::vector<std::string_view> tokens;
+		values.reserve(BLOCK_SIZE);
+		tokens.reserve(BLOCK_SIZE);
+
+		const auto& append{ [&](std::string_view const token, auto const result) {
+			if (records.enabled()) {
+				records.number(token);
+				records.number(divisorStr);
+				records.field(result);
+				records.end();
+				return;
+			}
+			char digits[128];
+			const char* end;
+			if constexpr (std::floating_point<decltype(result)>) {
+				if ((end = conv::format(digits, digits + sizeof(digits), result, floatFormat)) == nullptr)
+					end = std::to_chars(digits, digits + sizeof(digits), result, std::chars_format::scientific).ptr;
+			}
+			else end = std::to_chars(digits, digits + sizeof(digits), result).ptr;
+			if (!quiet)
+				out.append(lineBegin).append(token);
+			out.append(lineMiddle).append(static_cast<const char*>(digits), end).append(lineEnd);
+		} };
+		// calculates & prints all pending integers
+		const auto& flush{ [&]() {
+			divisor.remainder(values.data(), values.data(), values.size());
+			for (size_t i{ 0ull }; i < values.size(); ++i)
+				append(tokens[i], values[i]);
+			values.clear();
+			tokens.clear();
+		} };
+		const auto& process{ [&](std::string_view const token) {
+			if (!floatDivisor && !forceHex) {
+				modulo::IntT value;
+				if (const auto& [ptr, ec] { std::from_chars(token.data(), token.data() + token.size(), value) }; ec == std::errc{} && ptr == token.data() + token.size()) {
+					values.emplace_back(value);
+					tokens.emplace_back(token);
+					if (values.size() == BLOCK_SIZE)
+						flush();
+					return;
+				}
+			}
+			flush(); // keep the output in order
+			if (floatDivisor || token.find('.') != std::string_view::npos) { // floating-point
+				if (!str::isnumber(std::string{ token }))
+					throw make_exception("Invalid number: \"", token, "\"!");
+				append(token, modulo::Calculate<modulo::FloatT>(str::stold(std::string{ token }), str::stold(divisorStr)).getResult());
+			}
+			else // arbitrarily long or hexadecimal integer
+				append(token, modulo::remainder(token, reducer, forceHex ? 16u : modulo::detect_radix(token)));
+		} };
+
+		if (pendingInput) {
+			BlockReader reader;
+			for (auto block{ reader.next() }; !block.empty(); block = reader.next()) {
+				for_each_token(block, process);
+				flush(); // tokens are only valid until the next block is read
+			}
+		}
+		const auto& params{ args.getv_all<opt3::Parameter>() };
+		for (const auto& it : params)
+			process(it);
+		flush();
+	}
+	else for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
+		std::string here{ *it }, next{ "" };
+		if (const auto& pos{ here.find('%') }; pos != std::string::npos) {
+			next = here.substr(pos + 1ull);
+			here = here.substr(0ull, pos);
+		}
+		else if (std::distance(it, parameters.end()) >= 1ll) {
+			next = *++it;
+		}
+		else std::cerr << color.get_warn() << "Unmatched value: \"" << here << '\"' << std::endl;
+		if (here.find('^') != std::string::npos) { // modular exponentiation
+			const std::string input{ here + '%' + next };
+			const auto& expression{ exponents::parse(input) };
+			if (records.enabled()) {
+				records.number(here);
+				records.number(next);
+				records.field(expression.evaluate());
+				records.end();
+				continue;
+			}
+			if (!quiet)
+				buffer << expression << color.equals();
+			buffer << color(OUTCOLOR::OUTPUT) << expression.evaluate() << color() << '\n';
+			continue;
+		}
+		const auto& print{ [&](auto const result) {
+			if (records.enabled()) {
+				records.number(here);
+				records.number(next);
+				records.field(result);
+				records.end();
+				return;
+			}
+			if (!quiet)
+				buffer << color(OUTCOLOR::INPUT) << here << color() << ' ' << color(OUTCOLOR::OPERATOR) << '%' << color() << ' ' << color(OUTCOLOR::INPUT) << next << color() << color.equals();
+			buffer << color(OUTCOLOR::OUTPUT);
+			if constexpr (std::floating_point<decltype(result)>)
+				buffer << conv::formatted{ result };
+			else buffer << result;
+			buffer << color() << '\n';
+		} };
+		switch (modulo::find_num_type(here, next)) {
+		case modulo::NumberType::FLOAT:
+			print(modulo::Calculate(str::stold(here), str::stold(next)).getResult());
+			break;
+		case modulo::NumberType::INT: {
+			modulo::IntT value;
+			// the whole input must be the number; anything else is left for modulo::remainder to reject
+			if (const auto& [ptr, ec] { std::from_chars(here.data(), here.data() + here.size(), value) }; modulo::detect_radix(here) == 10u && ec == std::errc{} && ptr == here.data() + here.size())
+				print(modulo::Calculate(value, str::stoll(next)).getResult());
+			else { // arbitrarily long or hexadecimal input
+				const auto divisor{ str::stoll(next) };
+				print(modulo::remainder(here, modulo::Barrett{ divisor < 0 ? 0ull - static_cast<std::uint64_t>(divisor) : static_cast<std::uint64_t>(divisor) }, modulo::detect_radix(here)));
+			}
+			break;
+		}
+		}
+	}
+}
+
+// BITWISE
+template<> void ModeRunner::run<ModeID::Bitwise>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	bool binary{ false }; // no fmtflag for binary
+	std::ios_base& (*fmtFunction)(std::ios_base&) = &std::dec;
+	if (args.check_any<opt3::Flag, opt3::Option>('O', "octal"))
+		fmtFunction = &std::oct;
+	else if (args.check_any<opt3::Flag, opt3::Option>('x', "hex"))
+		fmtFunction = &std::hex;
+	else if (args.check_any<opt3::Flag, opt3::Option>('B', "binary"))
+		binary = true;
+
+	if (records.enabled())
+		records.header({ "expression", "result" });
+	for (const auto& expr : [/*&valid_operand, &valid_operator, &match_cfg*/](auto&& params) {
+		std::vector<std::string> vec;
+			vec.reserve(params.size());
+			std::string buf;
+			buf.reserve(64ull);
+			for (auto it{ params.begin() }; it != params.end(); ++it) {
+				if (str::endsWithAny(*it, ',', ';')) {
+					vec.emplace_back(buf + it->substr(0ull, it->size() - 2ull));
+						buf.clear();
+				}
+				else if (std::distance(it, params.end()) == 1) {
+					vec.emplace_back(buf + *it);
+					buf.clear();
+				}
+				//else if (const bool has_operator{ std::regex_match(*it, valid_operator, match_cfg) }, has_operand{ std::regex_match(*it, valid_operand, match_cfg) }; has_operator && has_operand) { // whole expression
+				//	vec.emplace_back(*it);
+				//}
+				else buf += *it;
+			}
+		vec.shrink_to_fit();
+		return vec;
+	}(parameters)) {
+		bitwise::operation oper{ bitwise::parse(expr) };
+		if (records.enabled()) {
+			records.field(str::stringify(oper));
+			if (records.binary())
+				records.field(oper.result());
+			else if (binary)
+				records.field(str::fromBase10(oper.result(), 2));
+			else if (fmtFunction != &std::dec)
+				records.field(str::stringify(fmtFunction, oper.result()));
+			else records.field(oper.result());
+			records.end();
+			continue;
+		}
+		if (!quiet)
+			buffer << oper << color.equals();
+		buffer << color(OUTCOLOR::OUTPUT);
+		if (binary)
+			buffer << str::fromBase10(oper.result(), 2);
+		else
+			buffer << fmtFunction << oper.result();
+		buffer << color() << '\n';
+	}
+}
+
+// EXP / POW
+template<> void ModeRunner::run<ModeID::Exponent>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	// expressions are delimited by commas & semicolons rather than whitespace, so STDIN is read whole
+	std::stringstream ss;
+	if (pendingInput)
+		ss << std::cin.rdbuf();
+	if (!parameters.empty()) // the last expression from STDIN doesn't have to end with a delimiter
+		ss << ';' << str::join(parameters, ' ');
+	const std::string input{ ss.str() };
+
+	if (records.enabled())
+		records.header({ "expression", "result" });
+	size_t count{ 0ull };
+	for (size_t begin{ 0ull }, end{ 0ull }; begin < input.size(); begin = end + 1ull) {
+		end = std::min(input.find_first_of(",;", begin), input.size());
+		const std::string_view expr{ input.data() + begin, end - begin };
+		if (std::all_of(expr.begin(), expr.end(), [](auto&& ch) { return std::isspace(static_cast<unsigned char>(ch)); }))
+			continue;
+
+		const auto& expression{ exponents::parse(expr) };
+		const auto& result{ expression.evaluate() };
+		if (records.enabled()) {
+			records.row(str::stringify(expression), result);
+			++count;
+			continue;
+		}
+		if (!quiet)
+			buffer << expression << color.equals();
+		buffer << color(OUTCOLOR::OUTPUT) << result << color() << '\n';
+		++count;
+	}
+
+	if (count == 0ull)
+		throw make_exception("No exponent expressions were specified!");
+}
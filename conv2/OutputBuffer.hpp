@@ -0,0 +1,156 @@
+/**
+ * @file	OutputBuffer.hpp
+ * @author	radj307
+ * @brief	The output sink shared by every mode; output is collected in one large buffer & written to STDOUT with as few system calls as possible.
+ */
+#pragma once
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+/**
+ * @class	OutputBuffer
+ * @brief	A stream buffer that writes directly to a file descriptor.
+ *\n		Output is flushed once the buffer holds at least the threshold number of bytes, or after every line when line buffering is enabled.
+ *\n		Modes that format their own output can append to it directly, or write into the space returned by prepare() to avoid copying.
+ */
+class OutputBuffer : public std::streambuf {
+	std::vector<char> buf;
+	size_t size{ 0ull };
+	size_t threshold;
+	int fd;
+	bool lineBuffered;
+
+	/// @brief	Writes the given bytes to the file descriptor, retrying until all of them are written.
+	bool write_all(const char* data, size_t count) const noexcept
+	{
+		while (count != 0ull) {
+		#ifdef _WIN32
+			const int n{ ::_write(fd, data, static_cast<unsigned>(std::min<size_t>(count, 1ull << 30))) };
+			if (n <= 0)
+				return false;
+		#else
+			const ssize_t n{ ::write(fd, data, count) };
+			if (n < 0) {
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+		#endif
+			data += n;
+			count -= static_cast<size_t>(n);
+		}
+		return true;
+	}
+
+protected:
+	int_type overflow(int_type const c) override
+	{
+		if (!traits_type::eq_int_type(c, traits_type::eof()))
+			push_back(traits_type::to_char_type(c));
+		return traits_type::not_eof(c);
+	}
+	std::streamsize xsputn(const char* s, std::streamsize const count) override
+	{
+		append(s, static_cast<size_t>(count));
+		return count;
+	}
+	int sync() override
+	{
+		return flush() ? 0 : -1;
+	}
+
+public:
+	static constexpr size_t DEFAULT_THRESHOLD{ 1ull << 20 };
+
+	/**
+	 * @brief				Constructor.
+	 * @param fd			The file descriptor to write to. Defaults to STDOUT.
+	 * @param threshold		The number of buffered bytes that triggers a flush.
+	 */
+	OutputBuffer(int const fd = 1, size_t const threshold = DEFAULT_THRESHOLD) : buf(threshold + (1ull << 16)), threshold{ threshold }, fd{ fd }, lineBuffered{ is_terminal(fd) } {}
+	~OutputBuffer() { flush(); }
+
+	OutputBuffer(OutputBuffer const&) = delete;
+	OutputBuffer& operator=(OutputBuffer const&) = delete;
+
+	/// @brief	Returns true when the given file descriptor is a terminal.
+	static bool is_terminal(int const fd) noexcept
+	{
+	#ifdef _WIN32
+		return ::_isatty(fd) != 0;
+	#else
+		return ::isatty(fd) != 0;
+	#endif
+	}
+
+	/// @brief	When enabled, output is flushed after every line instead of when the buffer fills up. This is enabled by default when writing to a terminal.
+	void setLineBuffered(bool const state) noexcept { lineBuffered = state; }
+	bool isLineBuffered() const noexcept { return lineBuffered; }
+
+	/**
+	 * @brief		Writes all buffered output.
+	 * @returns		true when successful; otherwise false. Buffered output is discarded either way.
+	 */
+	bool flush() noexcept
+	{
+		const bool result{ write_all(buf.data(), size) };
+		size = 0ull;
+		return result;
+	}
+
+	/**
+	 * @brief		Returns a pointer to at least count bytes of free space at the end of the buffer.
+	 *\n			Call commit() with the number of bytes that were actually used.
+	 * @param count	The maximum number of bytes that will be written.
+	 */
+	char* prepare(size_t const count)
+	{
+		if (buf.size() - size < count) {
+			flush();
+			if (buf.size() < count)
+				buf.resize(count);
+		}
+		return buf.data() + size;
+	}
+	/// @brief	Adds count bytes written to the space returned by prepare() to the output, then flushes if necessary.
+	void commit(size_t const count) noexcept
+	{
+		const char* const begin{ buf.data() + size };
+		size += count;
+		if (size >= threshold || (lineBuffered && std::memchr(begin, '\n', count) != nullptr))
+			flush();
+	}
+
+	OutputBuffer& append(const char* data, size_t const count)
+	{
+		std::memcpy(prepare(count), data, count);
+		commit(count);
+		return *this;
+	}
+	OutputBuffer& append(const char* first, const char* last) { return append(first, static_cast<size_t>(last - first)); }
+	OutputBuffer& append(std::string_view const s) { return append(s.data(), s.size()); }
+	OutputBuffer& append(size_t const count, char const c)
+	{
+		std::memset(prepare(count), c, count);
+		commit(count);
+		return *this;
+	}
+	OutputBuffer& push_back(char const c)
+	{
+		*prepare(1ull) = c;
+		commit(1ull);
+		return *this;
+	}
+	OutputBuffer& operator+=(std::string_view const s) { return append(s); }
+};
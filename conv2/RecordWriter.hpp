@@ -0,0 +1,464 @@
+/**
+ * @file	RecordWriter.hpp
+ * @author	radj307
+ * @brief	Machine-readable output formats (JSON Lines, CSV, TSV, & packed binary), written straight into the output buffer.
+ */
+#pragma once
+#include "OutputBuffer.hpp"
+
+#include <format.hpp>
+#include <make_exception.hpp>
+#include <str.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * @enum	RecordFormat
+ * @brief	The available output formats. Text is the default, human-readable format, which isn't handled by RecordWriter.
+ *\n		The binary formats are packed arrays of little-endian values, with one value per output field.
+ */
+enum class RecordFormat : unsigned char {
+	Text,
+	JSONL,
+	CSV,
+	TSV,
+	F64,
+	F32,
+	I64,
+	U64,
+};
+
+/**
+ * @brief		Parses the name of an output format.
+ * @param name	Input string; one of "text", "jsonl", "csv", or "tsv".
+ * @returns		RecordFormat
+ */
+inline RecordFormat parse_record_format(std::string_view const name)
+{
+	if (name == "text")
+		return RecordFormat::Text;
+	else if (name == "jsonl" || name == "json")
+		return RecordFormat::JSONL;
+	else if (name == "csv")
+		return RecordFormat::CSV;
+	else if (name == "tsv")
+		return RecordFormat::TSV;
+	throw make_exception("Invalid output format \"", name, "\"; expected \"text\", \"jsonl\", \"csv\", or \"tsv\"!");
+}
+/**
+ * @brief		Parses the name of a binary output format.
+ * @param name	Input string; one of "f64", "f32", "i64", or "u64".
+ * @returns		RecordFormat
+ */
+inline RecordFormat parse_binary_format(std::string_view const name)
+{
+	if (name == "f64")
+		return RecordFormat::F64;
+	else if (name == "f32")
+		return RecordFormat::F32;
+	else if (name == "i64")
+		return RecordFormat::I64;
+	else if (name == "u64")
+		return RecordFormat::U64;
+	throw make_exception("Invalid binary format \"", name, "\"; expected \"f64\", \"f32\", \"i64\", or \"u64\"!");
+}
+
+namespace detail {
+	template<typename... Ts> std::variant<Ts...> const& as_variant(std::variant<Ts...> const& v) noexcept { return v; }
+	template<typename... Ts> std::true_type is_variant(std::variant<Ts...> const*);
+	std::false_type is_variant(...);
+
+	/// @brief	Any std::variant, or type derived from one.
+	template<typename T> concept variant_like = decltype(is_variant(std::declval<T const*>()))::value;
+}
+
+/**
+ * @class	RecordWriter
+ * @brief	Writes records made up of named fields in one of the machine-readable formats.
+ *\n		The field names are set once with header(); each record is then written with row(), or with field() followed by end().
+ *\n		Strings are only escaped when they contain characters that need it.
+ */
+class RecordWriter {
+	OutputBuffer& out;
+	RecordFormat format;
+	conv::FloatFormat floatFormat;
+	// @brief	The text that precedes each field; for JSON, this includes the field's key.
+	std::vector<std::string> prefixes;
+	size_t column{ 0ull };
+	// @brief	The range of output fields; binary formats only write these fields.
+	size_t firstOutput{ 0ull }, lastOutput{ 0ull };
+	bool binaryHeader{ false };
+
+	/// @brief	Writes a value in the binary format, converting it if necessary.
+	template<typename T>
+	void write_binary(T const value)
+	{
+		const auto& put{ [this]<typename U>(U v) {
+			if constexpr (std::endian::native == std::endian::big) {
+				auto bytes{ std::bit_cast<std::array<unsigned char, sizeof(U)>>(v) };
+				std::reverse(bytes.begin(), bytes.end());
+				out.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+			}
+			else out.append(reinterpret_cast<const char*>(&v), sizeof(U));
+		} };
+		switch (format) {
+		case RecordFormat::F64:
+			put(static_cast<double>(value));
+			break;
+		case RecordFormat::F32:
+			put(static_cast<float>(value));
+			break;
+		case RecordFormat::I64:
+			put(to_integer<std::int64_t>(value));
+			break;
+		case RecordFormat::U64:
+			put(to_integer<std::uint64_t>(value));
+			break;
+		default:
+			break;
+		}
+	}
+	/// @brief	Converts a value to an integer format, rounding floating-point values to the nearest integer.
+	template<std::integral TOut, typename T>
+	static TOut to_integer(T const value)
+	{
+		if constexpr (std::floating_point<T>) {
+			const long double rounded{ std::round(static_cast<long double>(value)) };
+			const long double limit{ std::ldexp(1.0L, std::numeric_limits<TOut>::digits) }; //< exactly representable, unlike the maximum value
+			if (!(rounded >= (std::signed_integral<TOut> ? -limit : 0.0L) && rounded < limit))
+				throw make_exception("The value ", value, " can't be written as a", (std::signed_integral<TOut> ? " signed" : "n unsigned"), " 64-bit integer!");
+			return static_cast<TOut>(rounded);
+		}
+		else {
+			if (!std::in_range<TOut>(value))
+				throw make_exception("The value ", value, " can't be written as a", (std::signed_integral<TOut> ? " signed" : "n unsigned"), " 64-bit integer!");
+			return static_cast<TOut>(value);
+		}
+	}
+	/// @brief	Starts a field in a binary format; returns true when it is an output field that should be written.
+	bool begin_binary_field() noexcept
+	{
+		const size_t i{ column++ };
+		return i >= firstOutput && i < lastOutput;
+	}
+	/// @brief	Writes a number in text form in a binary format. Integers, including hexadecimal ones, are parsed exactly.
+	void write_binary(std::string_view const s)
+	{
+		const char* p{ s.data() }, * const end{ s.data() + s.size() };
+		if (p != end && *p == '+')
+			++p;
+		const bool negative{ p != end && *p == '-' };
+		if (negative)
+			++p;
+		const bool hex{ end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X') };
+
+		std::uint64_t magnitude; // from_chars doesn't accept a radix prefix, so it is skipped
+		if (const auto& [ptr, ec] { std::from_chars(hex ? p + 2 : p, end, magnitude, hex ? 16 : 10) }; ec == std::errc{} && ptr == end) {
+			if (!negative)
+				return write_binary(magnitude);
+			if (magnitude <= 1ull << 63)
+				return write_binary(static_cast<std::int64_t>(0ull - magnitude));
+		}
+		if (long double value; !hex) {
+			if (const auto& [ptr, ec] { std::from_chars(p, end, value) }; ec == std::errc{} && ptr == end)
+				return write_binary(negative ? -value : value);
+		}
+		throw make_exception("\"", s, "\" isn't a number, so it can't be written in a binary format!");
+	}
+
+	/// @brief	Returns true when the given string must be escaped or quoted in the current format.
+	bool needs_escape(std::string_view const s) const noexcept
+	{
+		switch (format) {
+		case RecordFormat::JSONL:
+			return std::any_of(s.begin(), s.end(), [](char const c) { return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\'; });
+		case RecordFormat::CSV:
+			return s.find_first_of(",\"\r\n") != std::string_view::npos;
+		case RecordFormat::TSV:
+			return s.find_first_of("\t\r\n\\") != std::string_view::npos;
+		default:
+			return false;
+		}
+	}
+
+	/// @brief	Writes a string, escaping it when necessary. JSON strings are always quoted.
+	void write_string(std::string_view const s)
+	{
+		const bool quote{ format == RecordFormat::JSONL };
+		if (!needs_escape(s)) {
+			if (quote) out.push_back('"');
+			out.append(s);
+			if (quote) out.push_back('"');
+			return;
+		}
+		switch (format) {
+		case RecordFormat::JSONL:
+			out.push_back('"');
+			for (const char c : s) {
+				switch (c) {
+				case '"': out.append("\\\"", 2ull); break;
+				case '\\': out.append("\\\\", 2ull); break;
+				case '\n': out.append("\\n", 2ull); break;
+				case '\r': out.append("\\r", 2ull); break;
+				case '\t': out.append("\\t", 2ull); break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						constexpr char HEX[]{ "0123456789abcdef" };
+						const char esc[]{ '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF] };
+						out.append(esc, sizeof(esc));
+					}
+					else out.push_back(c);
+					break;
+				}
+			}
+			out.push_back('"');
+			break;
+		case RecordFormat::CSV: // RFC 4180; double any quotes & enclose the field in quotes
+			out.push_back('"');
+			for (const char c : s) {
+				if (c == '"')
+					out.push_back('"');
+				out.push_back(c);
+			}
+			out.push_back('"');
+			break;
+		case RecordFormat::TSV: // tabs & line breaks can't be quoted, so they're written as escape sequences
+			for (const char c : s) {
+				switch (c) {
+				case '\t': out.append("\\t", 2ull); break;
+				case '\n': out.append("\\n", 2ull); break;
+				case '\r': out.append("\\r", 2ull); break;
+				case '\\': out.append("\\\\", 2ull); break;
+				default: out.push_back(c); break;
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	/// @brief	Writes the separator & key that precede the next field.
+	void begin_field()
+	{
+		if (column < prefixes.size())
+			out.append(prefixes[column]);
+		else // more fields than names; this is a bug in the caller, but the output should stay valid
+			out.append(format == RecordFormat::JSONL ? std::string_view{ ",\"\":" } : format == RecordFormat::CSV ? std::string_view{ "," } : std::string_view{ "\t" });
+		++column;
+	}
+
+public:
+	RecordWriter(OutputBuffer& out, RecordFormat const format, conv::FloatFormat const& floatFormat) : out{ out }, format{ format }, floatFormat{ floatFormat } {}
+
+	bool enabled() const noexcept { return format != RecordFormat::Text; }
+	bool binary() const noexcept { return format >= RecordFormat::F64; }
+
+	/// @brief	When enabled, binary output starts with a header that describes its format & fields. See header().
+	void setBinaryHeader(bool const state) noexcept { binaryHeader = state; }
+
+	/**
+	 * @brief				Sets the names of the fields in each record. CSV & TSV output starts with a header line containing them.
+	 *\n					Binary output only contains the output fields. When the binary header is enabled, it starts with:
+	 *\n					 the magic bytes "CONV2BIN", a u8 version (1), a u8 format (0=f64, 1=f32, 2=i64, 3=u64),
+	 *\n					 a u16 field count, a u32 total header size, then the NUL-terminated names of the output fields,
+	 *\n					 padded with zeros to a multiple of 8 bytes so the values that follow are aligned.
+	 * @param names			The field names, in the same order that fields are written.
+	 * @param firstOutput	The index of the first output field. By default, this is the first field named "output", "result", or "value".
+	 * @param outputCount	The number of consecutive output fields.
+	 */
+	void header(std::vector<std::string> const& names, size_t firstOutput = std::string::npos, size_t const outputCount = 1ull)
+	{
+		if (firstOutput == std::string::npos)
+			firstOutput = static_cast<size_t>(std::find_if(names.begin(), names.end(), [](auto&& name) { return name == "output" || name == "result" || name == "value"; }) - names.begin());
+		this->firstOutput = std::min(firstOutput, names.size());
+		this->lastOutput = std::min(this->firstOutput + outputCount, names.size());
+
+		if (binary()) {
+			if (!binaryHeader)
+				return;
+			std::string h{ "CONV2BIN" };
+			h += static_cast<char>(1);
+			h += static_cast<char>(static_cast<unsigned>(format) - static_cast<unsigned>(RecordFormat::F64));
+			const auto& put_le{ [&h](std::uint64_t v, size_t const bytes) {
+				for (size_t i{ 0ull }; i < bytes; ++i, v >>= 8)
+					h += static_cast<char>(v & 0xFF);
+			} };
+			put_le(lastOutput - this->firstOutput, 2ull);
+			const size_t sizePos{ h.size() };
+			put_le(0ull, 4ull);
+			for (size_t i{ this->firstOutput }; i < lastOutput; ++i)
+				h.append(names[i]).push_back('\0');
+			h.append((8ull - h.size() % 8ull) % 8ull, '\0');
+			for (size_t i{ 0ull }, size{ h.size() }; i < 4ull; ++i, size >>= 8)
+				h[sizePos + i] = static_cast<char>(size & 0xFF);
+			out.append(h);
+			binaryHeader = false; //< only write it once
+			return;
+		}
+
+		prefixes.clear();
+		prefixes.reserve(names.size());
+		for (size_t i{ 0ull }; i < names.size(); ++i) {
+			if (format == RecordFormat::JSONL) {
+				std::string key{ i == 0ull ? "{\"" : ",\"" };
+				for (const char c : names[i]) { // names are always plain text, but may contain quotes
+					if (c == '"' || c == '\\')
+						key += '\\';
+					key += c;
+				}
+				prefixes.emplace_back(key + "\":");
+			}
+			else prefixes.emplace_back(i == 0ull ? "" : format == RecordFormat::CSV ? "," : "\t");
+		}
+		if (format == RecordFormat::CSV || format == RecordFormat::TSV) {
+			for (const auto& name : names) {
+				begin_field();
+				write_string(name);
+			}
+			end();
+		}
+	}
+
+	/// @brief	Writes a string field.
+	void field(std::string_view const s)
+	{
+		if (binary()) {
+			if (begin_binary_field())
+				write_binary(s);
+			return;
+		}
+		begin_field();
+		write_string(s);
+	}
+	void field(const char* s) { field(std::string_view{ s }); }
+	void field(std::string const& s) { field(std::string_view{ s }); }
+	void field(char const c) { field(std::string_view{ &c, 1ull }); }
+
+	/// @brief	Writes a numeric field.
+	template<typename T> requires (std::integral<T> && !std::same_as<T, char> && !std::same_as<T, bool>)
+	void field(T const value)
+	{
+		if (binary()) {
+			if (begin_binary_field())
+				write_binary(value);
+			return;
+		}
+		begin_field();
+		char* const first{ out.prepare(24ull) };
+		out.commit(static_cast<size_t>(std::to_chars(first, first + 24ull, value).ptr - first));
+	}
+	/// @brief	Writes a floating-point field using the current formatting options. JSON has no representation for NaN or infinity, so they are written as null.
+	template<std::floating_point T>
+	void field(T const value)
+	{
+		if (binary()) {
+			if (begin_binary_field())
+				write_binary(value);
+			return;
+		}
+		begin_field();
+		if (format == RecordFormat::JSONL && !std::isfinite(value)) {
+			out.append("null", 4ull);
+			return;
+		}
+		const bool quote{ format == RecordFormat::JSONL && floatFormat.notation == conv::FloatFormat::Notation::Hex };
+		if (quote) out.push_back('"');
+		char* const first{ out.prepare(128ull) };
+		if (const char* end{ conv::format(first, first + 128ull, value, floatFormat) }; end != nullptr)
+			out.commit(static_cast<size_t>(end - first));
+		else out.append(str::stringify(value));
+		if (quote) out.push_back('"');
+	}
+	/// @brief	Writes a field holding one of the alternatives of a variant.
+	template<detail::variant_like T>
+	void field(T const& value)
+	{
+		std::visit([this](auto const& alt) { field(alt); }, detail::as_variant(value));
+	}
+	/// @brief	Writes a field holding any other streamable type (such as an arbitrary-precision integer) as a bare number.
+	template<typename T> requires (!std::is_arithmetic_v<T> && !std::convertible_to<T const&, std::string_view> && !detail::variant_like<T>)
+	void field(T const& value)
+	{
+		number(str::stringify(value));
+	}
+
+	/**
+	 * @brief		Writes a field that contains a number in text form.
+	 *\n			When it is a valid JSON number, it is written without quotes; otherwise, it is written as a string.
+	 * @param s		The number's text, exactly as it was given.
+	 */
+	void number(std::string_view const s)
+	{
+		if (binary() || format != RecordFormat::JSONL) {
+			field(s);
+			return;
+		}
+		// JSON numbers may not have a leading plus sign, leading zeros, or a radix prefix
+		const char* p{ s.data() }, * const end{ p + s.size() };
+		if (p != end && *p == '-')
+			++p;
+		bool valid{ p != end && std::isdigit(static_cast<unsigned char>(*p)) && !(*p == '0' && p + 1 != end && std::isdigit(static_cast<unsigned char>(p[1]))) };
+		if (valid) {
+			double discard;
+			const auto& [ptr, ec] { std::from_chars(p, end, discard) };
+			valid = ptr == end && (ec == std::errc{} || ec == std::errc::result_out_of_range) && ptr[-1] != '.';
+		}
+		if (!valid) {
+			field(s);
+			return;
+		}
+		begin_field();
+		out.append(s);
+	}
+
+	/// @brief	Ends the current record.
+	void end()
+	{
+		if (binary())
+			;
+		else if (format == RecordFormat::JSONL)
+			out.append("}\n", 2ull);
+		else out.push_back('\n');
+		column = 0ull;
+	}
+
+	/// @brief	Writes a complete record.
+	template<typename... Ts>
+	void row(Ts const&... values)
+	{
+		(field(values), ...);
+		end();
+	}
+
+	/**
+	 * @brief			Writes a block of records that each contain a single output value, in a binary format.
+	 *\n				When the value type already matches the output format, the block is copied as-is.
+	 * @param values	The output values.
+	 * @param count		The number of values.
+	 */
+	template<typename T>
+	void write_block(T const* values, size_t const count)
+	{
+		const bool same{ (format == RecordFormat::F64 && std::same_as<T, double>) || (format == RecordFormat::F32 && std::same_as<T, float>)
+			|| (format == RecordFormat::I64 && std::same_as<T, std::int64_t>) || (format == RecordFormat::U64 && std::same_as<T, std::uint64_t>) };
+		if (same && std::endian::native == std::endian::little)
+			out.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+		else for (size_t i{ 0ull }; i < count; ++i)
+			write_binary(values[i]);
+	}
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <opt3.hpp>
 #include <strconv.hpp>
+#include <format.hpp>
 
 #include <iostream>
 
@@ -18,14 +19,16 @@ public:
 		precision,
 		fixed,
 		scientific,
-		hexfloat;
+		hexfloat,
+		shortest;
 
 	StreamFormatter(const opt3::ArgManager* args) : args{ args },
 		showbase{ args->check<opt3::Option>("showbase") },
 		precision{ args->check<opt3::Option>("precision") },
 		fixed{ args->check<opt3::Option>("fixed") },
 		scientific{ args->check<opt3::Option>("scientific") },
-		hexfloat{ args->check<opt3::Option>("hexfloat") }
+		hexfloat{ args->check<opt3::Option>("hexfloat") },
+		shortest{ args->check<opt3::Option>("shortest") }
 	{}
 
 	/**
@@ -61,6 +64,10 @@ public:
 		else if (fmt.hexfloat)
 			os << std::hexfloat;
 
+		// SHORTEST (only affects values inserted with conv::formatted)
+		if (fmt.shortest)
+			os << conv::shortest;
+
 		return os;
 	}
 };
@@ -0,0 +1,358 @@
+/**
+ * @file	TextModes.cpp
+ * @author	radj307
+ * @brief	Text modes; ASCII tables, automatic detection, & annotation.
+ */
+#include "Modes.hpp"
+#include "Annotator.hpp"
+#include "AutoClassifier.hpp"
+#include "BlockReader.hpp"
+#include "MappedFile.hpp"
+#include "operators.hpp"
+
+#include <make_exception.hpp>
+#include <str.hpp>
+#include <TermAPI.hpp>
+
+#include <ascii.hpp>
+#include <bitwise.hpp>
+#include <format.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ASCII
+template<> void ModeRunner::run<ModeID::ASCII>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	const bool&
+		disallowReverseConversion{ args.check_any<opt3::Flag, opt3::Option>('N', "numeric") },
+		signedRange{ args.check_any<opt3::Flag, opt3::Option>('s', "signed") },
+		onePerLine{ args.check_any<opt3::Flag, opt3::Option>("linear") },
+		codePoints{ args.check_any<opt3::Flag, opt3::Option>('U', "utf8") },
+		hex{ args.check_any<opt3::Flag, opt3::Option>('x', "hex") };
+
+	const auto& filePath{ args.getv<opt3::Option>("file") };
+	if (records.enabled()) {
+		if (filePath.has_value())
+			records.header({ "index", "value" });
+		else records.header({ "input", "output" });
+	}
+
+	// File Dump Mode:
+	if (filePath.has_value()) {
+		const auto& table{ ascii::BYTE_TABLES[static_cast<size_t>(hex ? ascii::ByteFormat::Hex : (signedRange ? ascii::ByteFormat::Signed : ascii::ByteFormat::Unsigned))] };
+		constexpr size_t CHUNK_SIZE{ 1ull << 16 };
+
+		std::vector<char32_t> decoded(codePoints ? CHUNK_SIZE : 0ull);
+		size_t column{ 0ull }, position{ 0ull }, index{ 0ull };
+		// @returns	The number of bytes that were consumed; this is less than size only when the input ends partway through a UTF-8 sequence.
+		const auto& dump{ [&](const unsigned char* data, size_t size) {
+			size_t consumed{ 0ull };
+			while (size != 0ull) {
+				size_t n{ std::min(size, CHUNK_SIZE) };
+				if (codePoints) {
+					const auto& result{ ascii::utf8::decode(data, n, decoded.data()) };
+					if (result.error)
+						throw make_exception("Invalid UTF-8 sequence at byte ", position + result.read, "!");
+					if (result.read == 0ull) // wait for the rest of the sequence
+						break;
+					if (records.enabled()) for (size_t i{ 0ull }; i < result.written; ++i)
+						records.row(index++, static_cast<std::uint32_t>(decoded[i]));
+					else sink.commit(ascii::format_code_points(decoded.data(), result.written, sink.prepare(ascii::ByteTable::max_output_size(n)), hex, column, onePerLine ? 0ull : 8ull));
+					n = result.read;
+				}
+				else if (records.enabled()) for (size_t i{ 0ull }; i < n; ++i) {
+					if (signedRange)
+						records.row(position + i, static_cast<int>(static_cast<signed char>(data[i])));
+					else records.row(position + i, static_cast<unsigned>(data[i]));
+				}
+				else {
+					char* const out{ sink.prepare(ascii::ByteTable::max_output_size(n)) };
+					sink.commit(onePerLine ? table.format_linear(data, n, out) : table.format_table(data, n, out, column));
+				}
+				data += n;
+				size -= n;
+				consumed += n;
+				position += n;
+			}
+			return consumed;
+		} };
+		const auto& dump_stream{ [&](std::FILE* fp) {
+			std::vector<unsigned char> in(CHUNK_SIZE);
+			size_t carry{ 0ull };
+			for (size_t n{ std::fread(in.data(), 1ull, in.size(), fp) }; n != 0ull; n = std::fread(in.data() + carry, 1ull, in.size() - carry, fp)) {
+				n += carry;
+				const size_t used{ dump(in.data(), n) };
+				carry = n - used;
+				std::memmove(in.data(), in.data() + used, carry);
+			}
+			return carry == 0ull;
+		} };
+
+		bool complete{ true };
+		if (const std::string& path{ filePath.value() }; path == "-")
+			complete = dump_stream(stdin);
+		else if (const MappedFile file{ path }; file.is_mapped())
+			complete = dump(file.data(), file.size()) == file.size();
+		else if (std::FILE* fp{ std::fopen(path.c_str(), "rb") }; fp != nullptr) {
+			complete = dump_stream(fp);
+			std::fclose(fp);
+		}
+		else throw make_exception("Failed to open file \"", path, "\"!");
+
+		if (column != 0ull)
+			sink.push_back('\n');
+		if (!complete)
+			throw make_exception("Input ends with an incomplete UTF-8 sequence at byte ", position, "!");
+	}
+	// Code Point Mode:
+	else if (codePoints) for (const auto& it : parameters) {
+		if (records.enabled()) {
+			if (!disallowReverseConversion && std::all_of(it.begin(), it.end(), isdigit))
+				records.row(str::stoi(it), ascii::to_utf8({ str::stoi(it) }));
+			else for (const auto& v : ascii::to_ascii(std::string_view{ it }))
+				records.row(ascii::to_utf8({ v }), v);
+			continue;
+		}
+		// Allow Reverse Lookup:
+		if (!disallowReverseConversion && std::all_of(it.begin(), it.end(), isdigit)) {
+			if (!quiet)
+				buffer << color(OUTCOLOR::INPUT) << it << color() << color.equals();
+			buffer << color(OUTCOLOR::OUTPUT) << ascii::to_utf8({ str::stoi(it) }) << color() << ' ';
+		}
+		else {
+			const auto& values{ ascii::to_ascii(std::string_view{ it }) };
+			const auto& print_value{ [&hex](std::ostream& os, ascii::ValueT const v) -> std::ostream& {
+				if (hex)
+					return os << "U+" << std::uppercase << std::hex << std::setw(4) << std::setfill('0') << v << std::dec << std::nouppercase << std::setfill(' ');
+				return os << v;
+			} };
+
+			// One Per Line Mode:
+			if (onePerLine) for (const auto& v : values) {
+				if (!quiet)
+					buffer << color(OUTCOLOR::INPUT) << ascii::to_utf8({ v }) << color() << color.equals();
+				print_value(buffer << color(OUTCOLOR::OUTPUT), v) << color() << '\n';
+			}
+			// Table Mode:
+			else if (!quiet) {
+				std::vector<std::string> output;
+				output.reserve(values.size());
+				buffer << color(OUTCOLOR::OPERATOR) << '{' << color() << ' ';
+				for (const auto& v : values) {
+					std::stringstream ss;
+					print_value(ss, v);
+					const auto& out{ output.emplace_back(ss.str()) };
+					buffer << color(OUTCOLOR::INPUT) << ascii::to_utf8({ v }) << color() << indent(out.size() + 1ull);
+				}
+				buffer << color(OUTCOLOR::OPERATOR) << '}' << color() << '\n' << color(OUTCOLOR::OPERATOR) << '{' << color() << ' ';
+				for (const auto& out : output)
+					buffer << color(OUTCOLOR::OUTPUT) << out << color() << ' ';
+				buffer << color(OUTCOLOR::OPERATOR) << '}' << color();
+			}
+			// Quiet Non-Linear Mode:
+			else for (const auto& v : values)
+				print_value(buffer << color(OUTCOLOR::OUTPUT), v) << color() << ' ';
+		}
+		if (!onePerLine) buffer << '\n';
+	}
+	else for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
+		if (records.enabled()) {
+			if (!disallowReverseConversion && std::all_of(it->begin(), it->end(), isdigit)) {
+				int n{ str::stoi(*it) };
+				if (n > 127) n = -127 + n % 127;
+				records.row(str::stoi(*it), static_cast<char>(n));
+			}
+			else for (const auto& c : *it) {
+				if (signedRange)
+					records.row(c, static_cast<int>(static_cast<signed char>(c)));
+				else records.row(c, static_cast<unsigned>(static_cast<unsigned char>(c)));
+			}
+			continue;
+		}
+		// Allow Reverse Lookup:
+		if (!disallowReverseConversion && std::all_of(it->begin(), it->end(), isdigit)) {
+			if (!quiet)
+				buffer << color(OUTCOLOR::INPUT) << *it << color() << color.equals();
+			int n{ str::stoi(*it) };
+			// loopback
+			if (n > 127) n = -127 + n % 127;
+			const char c{ static_cast<char>(n) };
+			buffer << color(OUTCOLOR::OUTPUT) << c << color() << ' ';
+		}
+		// One Per Line Mode:
+		else if (onePerLine) {
+			for (const auto& c : *it) {
+				if (!quiet)
+					buffer << color(OUTCOLOR::INPUT) << c << color() << color.equals();
+				buffer << color(OUTCOLOR::OUTPUT) << (signedRange ? static_cast<signed short>(static_cast<signed char>(c)) : static_cast<unsigned short>(static_cast<unsigned char>(c))) << color() << '\n';
+			}
+		}
+		// Table Mode:
+		else if (!quiet) {
+			const size_t len{ it->size() };
+			std::vector<std::string> output;
+			output.reserve(len);
+			buffer << color(OUTCOLOR::OPERATOR) << '{' << color() << ' ';
+			for (const auto& c : *it) {
+				const auto& out{ std::to_string((signedRange ? static_cast<signed short>(static_cast<signed char>(c)) : static_cast<unsigned short>(static_cast<unsigned char>(c)))) };
+				output.emplace_back(out);
+				buffer << color(OUTCOLOR::INPUT) << c << color() << indent(out.size() + 1ull);
+			}
+			buffer << color(OUTCOLOR::OPERATOR) << '}' << color() << '\n' << color(OUTCOLOR::OPERATOR) << '{' << color() << ' ';
+
+			for (size_t i{ 0ull }, vecLen{ output.size() }; i < len && i < vecLen; ++i)
+				buffer << color(OUTCOLOR::OUTPUT) << output.at(i) << color() << ' ';
+			buffer << color(OUTCOLOR::OPERATOR) << '}' << color();
+		}
+		// Quiet Non-Linear Mode:
+		else for (const auto& c : *it)
+			buffer << color(OUTCOLOR::OUTPUT) << (signedRange ? static_cast<signed short>(static_cast<signed char>(c)) : static_cast<unsigned short>(static_cast<unsigned char>(c))) << color() << ' ';
+		if (!onePerLine) buffer << '\n';
+	}
+}
+
+// AUTO
+template<> void ModeRunner::run<ModeID::Auto>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	const UnitTable units;
+	const AutoClassifier classify{ units };
+	if (records.enabled())
+		records.header({ "kind", "input", "input_unit", "output", "output_unit" });
+
+	for (size_t i{ 0ull }; i < parameters.size(); ++i) {
+		const std::string_view arg{ parameters[i] };
+		Token token{ classify(arg) };
+
+		// bitwise expressions may be split across several parameters, & end at a comma or semicolon
+		if (token.kind == TokenKind::Expression || ((token.kind == TokenKind::Number || token.kind == TokenKind::Hexadecimal || token.kind == TokenKind::Binary)
+			&& i + 1ull < parameters.size() && AutoClassifier::continues_expression(parameters[i + 1ull]))) {
+			std::string expr{ arg };
+			long long depth{ std::count(expr.begin(), expr.end(), '(') - std::count(expr.begin(), expr.end(), ')') };
+			while (!str::endsWithAny(expr, ',', ';') && i + 1ull < parameters.size()
+				&& (depth > 0 || AutoClassifier::expects_operand(expr) || AutoClassifier::continues_expression(parameters[i + 1ull]))) {
+				const auto& next{ parameters[++i] };
+				depth += std::count(next.begin(), next.end(), '(') - std::count(next.begin(), next.end(), ')');
+				expr += ' ';
+				expr += next;
+			}
+			while (str::endsWithAny(expr, ',', ';'))
+				expr.pop_back();
+
+			bitwise::operation oper{ bitwise::parse(expr) };
+			if (records.enabled())
+				records.row("bitwise", str::stringify(oper), "", oper.result(), "");
+			else {
+				if (!quiet)
+					buffer << oper << color.equals();
+				buffer << color(OUTCOLOR::OUTPUT) << oper.result() << color() << '\n';
+			}
+			continue;
+		}
+
+		switch (token.kind) {
+		case TokenKind::Hexadecimal: [[fallthrough]];
+		case TokenKind::Binary: {
+			const bool hex{ token.kind == TokenKind::Hexadecimal };
+			std::uint64_t value;
+			if (const auto& [ptr, ec] { std::from_chars(token.value.data(), token.value.data() + token.value.size(), value, hex ? 16 : 2) }; ec != std::errc{})
+				throw make_exception("Number is too large: \"", arg, "\"!");
+			if (records.enabled())
+				records.row(hex ? "hex" : "binary", arg, "", value, "");
+			else {
+				if (!quiet)
+					buffer << color(OUTCOLOR::INPUT) << arg << color() << color.equals();
+				buffer << color(OUTCOLOR::OUTPUT) << value << color() << '\n';
+			}
+			break;
+		}
+		case TokenKind::Number:
+			// the unit is the next parameter
+			if (i + 1ull < parameters.size()) {
+				if (const Token unit{ classify(parameters[i + 1ull]) }; unit.kind == TokenKind::Unit) {
+					token = { TokenKind::Measurement, token.value, unit.unit };
+					++i;
+				}
+			}
+			if (token.kind != TokenKind::Measurement)
+				throw make_exception("Number \"", arg, "\" doesn't have a unit!");
+			[[fallthrough]];
+		case TokenKind::Measurement: {
+			const UnitInfo& in{ units[token.unit] };
+			const Token out{ i + 1ull < parameters.size() ? classify(parameters[i + 1ull]) : Token{} };
+			if (out.kind != TokenKind::Unit || units[out.unit].dimension != in.dimension)
+				throw make_exception("Expected a ", conv::units::dimension_name(in.dimension), " unit to convert \"", token.value, in.suffix, "\" to!");
+			++i;
+			long double value;
+			std::string_view number{ token.value };
+			if (number.starts_with('+'))
+				number.remove_prefix(1ull);
+			std::from_chars(number.data(), number.data() + number.size(), value);
+			const long double result{ in.to(units[out.unit])(value) };
+
+			const UnitInfo& outUnit{ units[out.unit] };
+			if (records.enabled())
+				records.row(conv::units::dimension_name(in.dimension), value, in.symbol(), result, outUnit.symbol());
+			else {
+				if (!quiet)
+					buffer << color(OUTCOLOR::INPUT) << conv::formatted{ value } << color() << in.suffix << color.equals();
+				buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ result } << color() << outUnit.suffix << '\n';
+			}
+			break;
+		}
+		default:
+			throw make_exception("Unrecognized input: \"", arg, "\"!");
+		}
+	}
+}
+
+// ANNOTATE
+template<> void ModeRunner::run<ModeID::Annotate>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		throw make_exception("--annotate copies its input text; it can't be used with --format or --binary-out!");
+	const bool replace{ args.check<opt3::Option>("replace") };
+	Annotator annotator{ sink, floatFormat, replace,
+		replace ? std::string{ color(OUTCOLOR::OUTPUT) } : color.span(' ', color(OUTCOLOR::OPERATOR), '(', color(OUTCOLOR::OUTPUT)),
+		replace ? std::string{ color() } : color.span(color(OUTCOLOR::OPERATOR), ')', color())
+	};
+	const auto& units{ args.getv_all<opt3::Parameter>() };
+	if (units.empty())
+		throw make_exception("--annotate requires at least one target unit!");
+	for (const auto& unit : units)
+		annotator.addTarget(unit);
+
+	if (const auto& filePath{ args.getv<opt3::Option>("file") }; filePath.has_value() && filePath.value() != "-") {
+		if (const MappedFile file{ filePath.value() }; file.is_mapped())
+			annotator.process({ reinterpret_cast<const char*>(file.data()), file.size() });
+		else if (std::FILE* fp{ std::fopen(filePath.value().c_str(), "rb") }; fp != nullptr) {
+			BlockReader reader{ fp, 1ull << 20, true };
+			for (auto block{ reader.next() }; !block.empty(); block = reader.next())
+				annotator.process(block);
+			std::fclose(fp);
+		}
+		else throw make_exception("Failed to open file \"", filePath.value(), "\"!");
+	}
+	else {
+		BlockReader reader{ stdin, 1ull << 20, true };
+		for (auto block{ reader.next() }; !block.empty(); block = reader.next())
+			annotator.process(block);
+	}
+	trailingNewline = false; //< the output ends the same way as the input
+}
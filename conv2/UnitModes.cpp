@@ -0,0 +1,521 @@
+/**
+ * @file	UnitModes.cpp
+ * @author	radj307
+ * @brief	Unit conversion modes; data sizes, lengths, temperatures, angles, fields of view, durations, & the generic unit converter.
+ */
+#include "Modes.hpp"
+#include "BlockReader.hpp"
+#include "globals.h"
+
+#include <make_exception.hpp>
+#include <str.hpp>
+#include <TermAPI.hpp>
+
+#include <data.hpp>
+#include <length.hpp>
+#include <rational.hpp>
+#include <radians.hpp>
+#include <FOV.hpp>
+#include <range.hpp>
+#include <format.hpp>
+#include <temperature.hpp>
+#include <compound.hpp>
+#include <duration.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+// RANGE UNITS
+namespace {
+	/// @brief	Resolves a pair of units with the unit engine. When dimension has a value, the input unit must be of that dimension.
+	UnitPair resolve_measurement(std::string const& in, std::string const& out, std::optional<conv::units::Dimension> const dimension = std::nullopt)
+	{
+		const auto& inUnit{ conv::units::parse(in) }, & outUnit{ conv::units::parse(out) };
+		if (dimension.has_value() && inUnit.dimensions != conv::units::dimensions_of(dimension.value()))
+			throw make_exception("\"", in, "\" isn't a ", conv::units::dimension_name(dimension.value()), " unit!");
+		return{ inUnit.to(outUnit), inUnit.symbol, outUnit.symbol, inUnit.suffix(), outUnit.suffix() };
+	}
+}
+
+
+// DATA
+template<> void ModeRunner::run<ModeID::Data>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		records.header({ "input", "input_unit", "output", "output_unit" });
+	for (std::vector<std::string>::const_iterator arg{ parameters.begin() }; arg != parameters.end(); ++arg) {
+		if (const auto conv{ data::Conversion(arg, parameters.end()) }; conv._in.has_value() && conv._out.has_value()) {
+			if (records.enabled()) {
+				const auto in{ conv._in.value().get() }, out{ conv._out.value().get() };
+				records.row(in->_value, in->_type._sym, out->_value, out->_type._sym);
+			}
+			else if (!quiet) { // print input values
+				const auto in{ conv._in.value().get() };
+				buffer
+					<< color(OUTCOLOR::INPUT) << conv::formatted{ in->_value } << color()
+					<< ' ' << in->_type
+					<< color.equals();
+			}
+			if (!records.enabled()) {
+				const auto out{ conv._out.value().get() };
+				buffer
+					<< color(OUTCOLOR::OUTPUT) << conv::formatted{ out->_value } << color()
+					<< ' ' << out->_type << '\n';
+			}
+		}
+	}
+}
+
+template<> UnitPair resolve_units<ModeID::Data>(std::string const& in, std::string const& out)
+{
+	return resolve_measurement(in, out, conv::units::Dimension::Data);
+}
+
+// LENGTH
+template<> void ModeRunner::run<ModeID::Length>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	const auto& is_value{ [](const std::string_view& str) -> bool {
+		return std::all_of(str.begin(), str.end(), [](auto&& c) {return isdigit(c) || c == '.' || c == '-'; });
+	} };
+	const auto& get_tuple{ [&is_value](auto&& it) {
+		const auto fst{ *it };
+		const auto snd{ *++it };
+		const auto thr{ *++it };
+		if (is_value(snd))
+			return std::make_tuple(fst, snd, thr);
+		else return std::make_tuple(snd, fst, thr);
+	} };
+	if (records.enabled())
+		records.header({ "input", "input_unit", "output", "output_unit" });
+	const bool exact{ args.check<opt3::Option>("exact") };
+#if !defined(__SIZEOF_INT128__)
+	if (exact)
+		throw make_exception("--exact requires 128-bit integer support, which this build of conv2 doesn't have!");
+#endif
+	for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
+		// every conversion has 3 parameters
+		if (std::distance(it, parameters.end()) < 3ll)
+			throw make_exception("Missing output unit after \"", std::next(it) == parameters.end() ? *it : *it + ' ' + *std::next(it), "\"!");
+	#if defined(__SIZEOF_INT128__)
+		if (exact) {
+			// the value is parsed into an integer & a power of ten, multiplied by the exact factor, & only rounded when it is printed
+			const auto& [in_name, value, out_name] { get_tuple(it) };
+			const auto& in_unit{ length::getUnit(in_name) }, & out_unit{ length::getUnit(out_name) };
+			conv::decimal input;
+			if (const auto& [ptr, ec] { conv::parse_decimal(value.data(), value.data() + value.size(), input) }; ec != std::errc{} || ptr != value.data() + value.size())
+				throw make_exception(ec == std::errc::result_out_of_range ? "Too many digits to convert exactly: \"" : "Invalid number: \"", value, "\"!");
+			char buf[128];
+			const auto& [end, ec] { conv::format(buf, buf + sizeof(buf), input, length::exact::factor(in_unit, out_unit), floatFormat) };
+			if (ec != std::errc{})
+				throw make_exception("Converting ", value, ' ', in_unit.getSymbol(), " to ", out_unit.getSymbol(), " exactly needs more than 128 bits!");
+			const std::string_view result{ buf, static_cast<size_t>(end - buf) };
+			if (records.enabled()) {
+				records.number(value);
+				records.field(in_unit.getSymbol());
+				records.number(result);
+				records.field(out_unit.getSymbol());
+				records.end();
+				continue;
+			}
+			if (!quiet) buffer << color(OUTCOLOR::INPUT) << value << color() << ' ' << in_unit << color.equals();
+			buffer << color(OUTCOLOR::OUTPUT) << result << color();
+			if (!quiet) buffer << ' ' << out_unit;
+			buffer << '\n';
+			continue;
+		}
+	#endif
+		const auto& [in_unit, value, out_unit] { length::Convert(get_tuple(it))._vars };
+		const auto result{ length::Convert::getResult(in_unit, value, out_unit) };
+		if (records.enabled()) {
+			records.row(value, in_unit.getSymbol(), result, out_unit.getSymbol());
+			continue;
+		}
+		if (!quiet) buffer << color(OUTCOLOR::INPUT) << value << color() << ' ' << in_unit << color.equals();
+		buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ result } << color();
+		if (!quiet) buffer << ' ' << out_unit;
+		buffer << '\n';
+	}
+}
+
+template<> UnitPair resolve_units<ModeID::Length>(std::string const& in, std::string const& out)
+{
+	return resolve_measurement(in, out, conv::units::Dimension::Length);
+}
+
+// RADIANS
+template<> void ModeRunner::run<ModeID::Radians>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		records.header({ "input", "input_unit", "output", "output_unit" });
+	for (const auto& it : parameters) {
+		std::string lower{ str::tolower(it) };
+
+		const bool in_radians{ str::endsWith(lower, 'c') || str::endsWith(lower, 'r') || str::endsWith(lower, "rad") };
+		lower.erase(std::remove_if(lower.begin(), lower.end(), isalpha), lower.end());
+
+		const auto v{ str::stold(lower) };
+		if (records.enabled()) {
+			if (in_radians)
+				records.row(v, "rad", toDegrees(v), "deg");
+			else records.row(v, "deg", toRadians(v), "rad");
+			continue;
+		}
+		if (!quiet) {
+			buffer << color(OUTCOLOR::INPUT) << conv::formatted{ v } << color() << ' ';
+			if (in_radians)
+				buffer << "rad";
+			else
+				buffer << "deg";
+			buffer << color.equals();
+		}
+		if (in_radians)
+			buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ toDegrees(v) } << color() << ' ' << "deg" << '\n';
+		else
+			buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ toRadians(v) } << color() << ' ' << "rad" << '\n';
+	}
+}
+
+template<> UnitPair resolve_units<ModeID::Radians>(std::string const& in, std::string const& out)
+{
+	const auto& is_radians{ [](std::string const& unit) {
+		if (const auto& lower{ str::tolower(unit) }; lower == "rad" || lower == "r" || lower == "radians")
+			return true;
+		else if (lower == "deg" || lower == "d" || lower == "degrees")
+			return false;
+		throw make_exception("Invalid angle unit: \"", unit, "\"; expected \"deg\" or \"rad\"!");
+	} };
+	const bool inRadians{ is_radians(in) }, outRadians{ is_radians(out) };
+	UnitPair units;
+	units.inName = inRadians ? "rad" : "deg";
+	units.outName = outRadians ? "rad" : "deg";
+	if (inRadians != outRadians)
+		units.transform.scale = inRadians ? toDegrees(1.0L) : toRadians(1.0L);
+	units.inUnit = ' ' + units.inName;
+	units.outUnit = ' ' + units.outName;
+	return units;
+}
+
+// FOV
+template<> void ModeRunner::run<ModeID::FOV>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	const auto& fov{ args.getv_any<opt3::Flag, opt3::Option>('F', "FOV") };
+	const bool& radians{ args.check_any<opt3::Flag, opt3::Option>('R', "rad") },
+		& round{ args.check_any<opt3::Flag, opt3::Option>('r', "round") };
+
+	if (!fov.has_value())
+		throw make_exception("Detected mode: FOV\n", indent(10), "No aspect ratio was specified!");
+
+	const auto& parse_aspect{ [](std::string_view const s) {
+		if (const auto& pos{ s.find(':') }; pos != std::string_view::npos)
+			return FOV::AspectRatio{ str::stoui(std::string{ s.substr(0ull, pos) }), str::stoui(std::string{ s.substr(pos + 1ull) }) };
+		throw make_exception("Invalid aspect ratio specifier: \"", s, "\"!\n", indent(10), "Aspect ratios must be in the format \"Horizontal:Vertical\".");
+	} };
+
+	// aspect ratios may be separated by commas
+	std::vector<std::string_view> aspectNames;
+	for (std::string_view captured{ fov.value() }; !captured.empty(); ) {
+		const size_t pos{ std::min(captured.find(','), captured.size()) };
+		if (pos != 0ull)
+			aspectNames.emplace_back(captured.substr(0ull, pos));
+		captured.remove_prefix(std::min<size_t>(pos + 1ull, captured.size()));
+	}
+
+	// Sweep Mode:
+	if (const auto& sweepArg{ args.getv<opt3::Option>("sweep") }; sweepArg.has_value()) {
+		std::string_view spec{ sweepArg.value() };
+		const bool vertical{ !spec.empty() && std::toupper(static_cast<unsigned char>(spec.back())) == 'V' };
+		if (!spec.empty() && std::isalpha(static_cast<unsigned char>(spec.back())))
+			spec.remove_suffix(1ull);
+		const auto& sweep{ conv::parse_range<double>(spec) };
+
+		// parameters in the format "H:V" are additional aspect ratios
+		for (const auto& it : parameters)
+			if (it.find(':') != std::string::npos)
+				aspectNames.emplace_back(it);
+
+		std::vector<double> factors;
+		factors.reserve(aspectNames.size());
+		for (const auto& name : aspectNames) {
+			const auto& aspect{ parse_aspect(name) };
+			factors.emplace_back(static_cast<double>(vertical ? aspect.horizontalOverVertical() : aspect.verticalOverHorizontal()));
+		}
+
+		constexpr size_t BLOCK_SIZE{ 1024ull }, WIDTH{ 12ull };
+		auto& out{ sink };
+		const auto& append_cell{ [&out](std::string_view const text) {
+			out.append(text.size() < WIDTH ? WIDTH - text.size() : 1ull, ' ');
+			out.append(text);
+		} };
+		const auto& append_number{ [&](double const value) {
+			char text[32];
+			if (const char* end{ conv::format(text, text + sizeof(text), value, floatFormat) }; end != nullptr)
+				append_cell({ text, static_cast<size_t>(end - text) });
+			else append_cell(conv::to_string(value, floatFormat));
+		} };
+
+		// header
+		const std::string inputBegin{ color(OUTCOLOR::INPUT) }, outputBegin{ color.span(color(), color(OUTCOLOR::OUTPUT)) }, lineEnd{ color.span(color(), '\n') };
+		if (records.enabled()) {
+			std::vector<std::string> names{ str::stringify(vertical ? 'V' : 'H', (radians ? " rad" : "")) };
+			for (const auto& name : aspectNames)
+				names.emplace_back(str::stringify(name, ' ', vertical ? 'H' : 'V'));
+			records.header(names, 1ull, aspectNames.size());
+		}
+		else if (!quiet) {
+			out += inputBegin;
+			append_cell(str::stringify(vertical ? 'V' : 'H', (radians ? " rad" : "")));
+			out += outputBegin;
+			for (const auto& name : aspectNames)
+				append_cell(str::stringify(name, ' ', vertical ? 'H' : 'V'));
+			out += lineEnd;
+		}
+
+		std::vector<double> inputs(BLOCK_SIZE), tangents(BLOCK_SIZE), results(BLOCK_SIZE * factors.size());
+		for (size_t i{ 0ull }, total{ sweep.size() }; i < total; i += BLOCK_SIZE) {
+			const size_t count{ std::min(BLOCK_SIZE, total - i) };
+			for (size_t k{ 0ull }; k < count; ++k)
+				inputs[k] = sweep[i + k];
+			FOV::half_tangents(inputs.data(), tangents.data(), count, radians);
+			for (size_t r{ 0ull }; r < factors.size(); ++r)
+				FOV::convert_tangents(tangents.data(), results.data() + r * BLOCK_SIZE, count, factors[r], radians);
+
+			if (records.enabled()) for (size_t k{ 0ull }; k < count; ++k) {
+				records.field(inputs[k]);
+				for (size_t r{ 0ull }; r < factors.size(); ++r)
+					records.field(round ? std::round(results[r * BLOCK_SIZE + k]) : results[r * BLOCK_SIZE + k]);
+				records.end();
+			}
+			else for (size_t k{ 0ull }; k < count; ++k) {
+				out += inputBegin;
+				append_number(inputs[k]);
+				out += outputBegin;
+				for (size_t r{ 0ull }; r < factors.size(); ++r)
+					append_number(round ? std::round(results[r * BLOCK_SIZE + k]) : results[r * BLOCK_SIZE + k]);
+				out += lineEnd;
+			}
+		}
+	}
+	else {
+		if (aspectNames.size() != 1ull)
+			throw make_exception("Detected mode: FOV\n", indent(10), "Multiple aspect ratios can only be used with --sweep!");
+		const auto& aspect{ parse_aspect(aspectNames.front()) };
+		if (records.enabled())
+			records.header({ "input", "input_axis", "output", "output_axis" });
+
+		for (std::string it : parameters) {
+			bool vertical{ str::endsWith(str::toupper(it), 'V') };
+			it.erase(std::remove_if(it.begin(), it.end(), isalpha), it.end());
+			if (records.enabled()) {
+				const FOV::value in{ str::stold(it) };
+				const FOV::value out{ radians
+					? (vertical ? FOV::toHorizontalR(in, aspect) : FOV::toVerticalR(in, aspect))
+					: (vertical ? FOV::toHorizontal(in, aspect) : FOV::toVertical(in, aspect)) };
+				records.row(in, vertical ? 'V' : 'H', round ? std::round(out) : out, vertical ? 'H' : 'V');
+				continue;
+			}
+			if (!quiet)
+				buffer << color(OUTCOLOR::INPUT) << it << color() << (radians ? " rad" : "") << ' ' << (vertical ? 'V' : 'H') << color.equals();
+
+			FOV::value const& in{ str::stold(it) };
+
+			FOV::value out{ 0.0L };
+
+			if (radians) {
+				if (vertical)
+					out = FOV::toHorizontalR(in, aspect);
+				else
+					out = FOV::toVerticalR(in, aspect);
+				buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ round ? std::round(out) : out } << color() << " rad" << ' ' << (vertical ? 'H' : 'V') << '\n';
+			}
+			else {
+				if (vertical)
+					out = FOV::toHorizontal(in, aspect);
+				else
+					out = FOV::toVertical(in, aspect);
+				buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ round ? std::round(out) : out } << color() << ' ' << (vertical ? 'H' : 'V') << '\n';
+			}
+		}
+	}
+}
+
+// TEMPERATURE
+template<> void ModeRunner::run<ModeID::Temperature>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		records.header({ "input", "input_unit", "output", "output_unit" });
+	const auto& print{ [this](conv::TempConversion<long double> const& conversion) {
+		const auto& result{ conversion.getResult() };
+		if (records.enabled()) {
+			records.row(conversion.temperature_value.value, conv::getTemperatureSystemSymbol(conversion.temperature_value.system), result.value, conv::getTemperatureSystemSymbol(result.system));
+			return;
+		}
+		buffer
+			<< color(OUTCOLOR::INPUT) << conv::formatted{ conversion.temperature_value.value } << color() << conv::getTemperatureSystemSymbol(conversion.temperature_value.system)
+			<< color.equals()
+			<< color(OUTCOLOR::OUTPUT) << conv::formatted{ result.value } << color() << conv::getTemperatureSystemSymbol(result.system)
+			<< '\n';
+	} };
+
+	conv::TemperatureScanner<long double> scanner;
+	if (pendingInput) {
+		BlockReader reader;
+		for (auto block{ reader.next() }; !block.empty(); block = reader.next())
+			for_each_token(block, [&](std::string_view const token) { scanner.feed(token, print); });
+	}
+	for (const auto& it : args.getv_all<opt3::Parameter>())
+		scanner.feed(it, print);
+	if (scanner.pending())
+		throw make_exception("Missing output temperature system!");
+}
+
+template<> UnitPair resolve_units<ModeID::Temperature>(std::string const& in, std::string const& out)
+{
+	return resolve_measurement(in, out, conv::units::Dimension::Temperature);
+}
+
+// UNIT
+template<> void ModeRunner::run<ModeID::Unit>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	conv::units::Cache cache;
+	if (records.enabled())
+		records.header({ "input", "input_unit", "output", "output_unit" });
+	for (size_t i{ 0ull }; i < parameters.size(); ++i) {
+		// the value may be followed directly by its unit, ex: "5km"
+		std::string_view arg{ parameters[i] };
+		if (arg.starts_with('+'))
+			arg.remove_prefix(1ull);
+		long double value;
+		const auto& [ptr, ec] { std::from_chars(arg.data(), arg.data() + arg.size(), value) };
+		if (ec != std::errc{})
+			throw make_exception("Expected a number, not \"", parameters[i], "\"!");
+		std::string_view inName{ ptr, static_cast<size_t>(arg.data() + arg.size() - ptr) };
+		if (inName.empty()) {
+			if (++i == parameters.size())
+				throw make_exception("Number \"", arg, "\" doesn't have a unit!");
+			inName = parameters[i];
+		}
+		if (++i == parameters.size())
+			throw make_exception("Expected a unit to convert \"", arg.substr(0ull, static_cast<size_t>(ptr - arg.data())), ' ', inName, "\" to!");
+
+		const auto& plan{ cache.plan(inName, parameters[i]) };
+		const long double result{ plan.transform(value) };
+		if (records.enabled()) {
+			records.row(value, plan.from->symbol, result, plan.to->symbol);
+			continue;
+		}
+		if (!quiet)
+			buffer << color(OUTCOLOR::INPUT) << conv::formatted{ value } << color() << plan.from->suffix() << color.equals();
+		buffer << color(OUTCOLOR::OUTPUT) << conv::formatted{ result } << color() << plan.to->suffix() << '\n';
+	}
+}
+
+template<> UnitPair resolve_units<ModeID::Unit>(std::string const& in, std::string const& out)
+{
+	return resolve_measurement(in, out);
+}
+
+// TIME
+template<> void ModeRunner::run<ModeID::Time>()
+{
+	using conv2::OUTCOLOR;
+	using conv2::color;
+
+	if (records.enabled())
+		records.header({ "input", "output", "output_unit" });
+	const std::string lineBegin{ quiet ? "" : std::string{ color(OUTCOLOR::INPUT) } };
+	const std::string lineMiddle{ quiet ? std::string{ color(OUTCOLOR::OUTPUT) } : color.span(color(), color.equals(), color(OUTCOLOR::OUTPUT)) };
+	std::string lineEnd;
+	// the unit that durations are converted to, or nullptr to write them in compound form
+	conv::duration::Unit const* unit{ nullptr };
+	const auto& set_unit{ [&](conv::duration::Unit const* const target) {
+		unit = target;
+		lineEnd = color.span(color(), (quiet || unit == nullptr) ? std::string{} : std::string{ " " }.append(unit->symbol), '\n');
+	} };
+
+	const auto& convert{ [&](std::string_view const token) {
+		std::int64_t ticks;
+		if (const auto& [ptr, ec] { conv::duration::parse(token.data(), token.data() + token.size(), ticks) }; ec != std::errc{} || ptr != token.data() + token.size())
+			throw make_exception(ec == std::errc::result_out_of_range ? "Duration is too long: \"" : "Invalid duration: \"", token, "\"!");
+		if (records.enabled()) {
+			// compound durations aren't numbers, so records always have a unit
+			conv::duration::Unit const& recordUnit{ unit == nullptr ? *conv::duration::find("ns") : *unit };
+			char buf[64];
+			records.field(token);
+			if (const char* end{ conv::duration::format(buf, buf + sizeof(buf), ticks, recordUnit, floatFormat) }; end != nullptr)
+				records.number({ buf, static_cast<size_t>(end - buf) });
+			else records.field(conv::duration::count(ticks, recordUnit)); // a fraction too long for the buffer
+			records.field(recordUnit.symbol);
+			records.end();
+			return;
+		}
+		sink += lineBegin;
+		if (!quiet)
+			sink += token;
+		sink += lineMiddle;
+		char* const buf{ sink.prepare(64ull) };
+		if (const char* end{ unit == nullptr ? conv::duration::format(buf, buf + 64, ticks) : conv::duration::format(buf, buf + 64, ticks, *unit, floatFormat) }; end != nullptr)
+			sink.commit(static_cast<size_t>(end - buf));
+		else buffer << conv::formatted{ conv::duration::count(ticks, *unit) }; // compound durations always fit, so this is a fraction too long for the buffer
+		sink += lineEnd;
+	} };
+
+	// each duration on the commandline is converted to the next output unit after it
+	conv::duration::Unit const* target{ nullptr };
+	for (size_t i{ 0ull }, pending{ 0ull }; i <= parameters.size(); ++i) {
+		conv::duration::Unit const* const next{ i < parameters.size() ? conv::duration::find(parameters[i]) : nullptr };
+		if (next == nullptr && i < parameters.size())
+			continue;
+		set_unit(next);
+		for (; pending < i; ++pending)
+			convert(parameters[pending]);
+		pending = i + 1ull;
+		if (next != nullptr)
+			target = next;
+	}
+	// durations from STDIN are converted to the last output unit on the commandline
+	if (pendingInput) {
+		set_unit(target);
+		BlockReader reader;
+		for (auto block{ reader.next() }; !block.empty(); block = reader.next())
+			for_each_token(block, convert);
+	}
+}
+
+template<> UnitPair resolve_units<ModeID::Time>(std::string const& in, std::string const& out)
+{
+	const auto& find_unit{ [](std::string const& unit) {
+		if (const auto* const found{ conv::duration::find(unit) }; found != nullptr)
+			return found;
+		throw make_exception("Invalid time unit: \"", unit, "\"!");
+	} };
+	const auto* const inUnit{ find_unit(in) }, * const outUnit{ find_unit(out) };
+	UnitPair units;
+	units.inName = inUnit->symbol;
+	units.outName = outUnit->symbol;
+	units.transform.scale = static_cast<long double>(inUnit->ticks) / static_cast<long double>(outUnit->ticks);
+	units.inUnit = ' ' + units.inName;
+	units.outUnit = ' ' + units.outName;
+	return units;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file	UnitTable.hpp
+ * @author	radj307
+ * @brief	An exact-match lookup table of every unit that the unit engine knows, for modes that have to recognize units in arbitrary text.
+ */
+#pragma once
+#include <units.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace detail {
+	/// @brief	Hashes std::string & std::string_view keys alike, so that lookups don't allocate.
+	struct string_hash {
+		using is_transparent = void;
+		size_t operator()(std::string_view const s) const noexcept { return std::hash<std::string_view>{}(s); }
+	};
+}
+
+/**
+ * @struct	UnitInfo
+ * @brief	A unit, & the transform that converts values in it to the base unit of its dimension.
+ */
+struct UnitInfo {
+	conv::units::Dimension dimension;
+	conv::affine toBase;
+	// @brief	When true, the unit may be separated from its value by a space. This is false for short symbols that are also common words.
+	bool spaced;
+	// @brief	The text printed after values in this unit, including any separator.
+	std::string suffix;
+
+	/// @brief	Returns the unit's symbol, without the separator.
+	std::string_view symbol() const noexcept { return std::string_view{ suffix }.substr(suffix.starts_with(' ') ? 1ull : 0ull); }
+
+	/// @brief	Returns the transform that converts values in this unit to the given unit, which must have the same dimension.
+	constexpr conv::affine to(UnitInfo const& target) const noexcept
+	{
+		return toBase.then({ 1.0L / target.toBase.scale, -target.toBase.offset / target.toBase.scale });
+	}
+};
+
+/**
+ * @class	UnitTable
+ * @brief	Maps every symbol & name that the unit engine accepts, with each of its prefixes, to their UnitInfo.
+ *\n		Unlike conv::units::find(), keys must match exactly & keys that are usually something else are left out;
+ *\n		 this is what makes it safe to use on text that isn't known to contain units.
+ */
+class UnitTable {
+	std::vector<UnitInfo> units;
+	std::unordered_map<std::string, size_t, detail::string_hash, std::equal_to<>> lookup;
+
+	/// @brief	Returns true for short keys that are usually words, which may only directly follow their value.
+	static bool is_word(std::string_view const key) noexcept
+	{
+		return key.size() == 1ull || key == "in" || key == "as" || key == "at";
+	}
+
+public:
+	static constexpr size_t npos{ std::string::npos };
+
+	UnitTable()
+	{
+		conv::units::for_each_key([this](std::string const& key, conv::units::Unit const& unit) {
+			// "am" & "pm" are usually times, & plain "K" usually means thousands
+			if (key == "am" || key == "pm" || key == "K" || lookup.contains(key))
+				return;
+			units.push_back({ unit.dimension(), unit.to_base(), !is_word(key), unit.suffix() });
+			lookup.emplace(key, units.size() - 1ull);
+		});
+	}
+
+	/// @brief	Returns the index of the unit with the given symbol or name, or npos.
+	size_t find(std::string_view const key) const
+	{
+		const auto& it{ lookup.find(key) };
+		return it == lookup.end() ? npos : it->second;
+	}
+
+	size_t size() const noexcept { return units.size(); }
+	UnitInfo const& operator[](size_t const index) const noexcept { return units[index]; }
+};
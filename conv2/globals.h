@@ -1,6 +1,11 @@
 #pragma once
 #include <TermAPI.hpp>
 #include <palette.hpp>
+#include <str.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
 
 namespace conv2 {
 	enum class OUTCOLOR : unsigned char {
@@ -10,11 +15,96 @@ namespace conv2 {
 		OPERATOR,
 		HIGHLIGHT,
 	};
-	term::palette<OUTCOLOR> color{
+	inline term::palette<OUTCOLOR> palette{
 		std::make_pair(OUTCOLOR::NONE, color::white),
 		std::make_pair(OUTCOLOR::INPUT, color::yellow),
 		std::make_pair(OUTCOLOR::OUTPUT, color::green),
 		std::make_pair(OUTCOLOR::OPERATOR, color::white),
 		std::make_pair(OUTCOLOR::HIGHLIGHT, color::red),
 	};
+
+	/**
+	 * @struct	ColorSpans
+	 * @brief	The palette's escape sequences, rendered once so that inserting one into the output is a single copy.
+	 *\n		Every span is empty while colors are disabled, so colorless output never pays for them.
+	 */
+	struct ColorSpans {
+	private:
+		std::array<std::string, 5ull> sets;
+		std::string reset, separator{ " = " };
+		bool active{ false };
+
+		/// @brief	Returns true when the given SGR parameters reset all attributes.
+		static bool is_reset(std::string_view const params) noexcept { return params.empty() || params == "0"; }
+
+	public:
+		/**
+		 * @brief			Combines adjacent SGR escape sequences in the given string into one sequence,
+		 *\n				 & removes sequences whose effect is immediately cancelled by a reset.
+		 * @param s			Input string.
+		 * @returns			The combined string.
+		 */
+		static std::string combine(std::string_view s)
+		{
+			std::string out, params;
+			bool pending{ false };
+			const auto& end_sequence{ [&]() {
+				if (pending)
+					out.append("\x1b[").append(params).push_back('m');
+				params.clear();
+				pending = false;
+			} };
+			while (!s.empty()) {
+				if (s.starts_with("\x1b[")) {
+					if (const auto& pos{ s.find_first_not_of("0123456789;", 2ull) }; pos != std::string_view::npos && s[pos] == 'm') {
+						const auto& next{ s.substr(2ull, pos - 2ull) };
+						if (is_reset(next)) // a reset cancels everything before it
+							params = "0";
+						else {
+							if (!params.empty())
+								params += ';';
+							params.append(next);
+						}
+						pending = true;
+						s.remove_prefix(pos + 1ull);
+						continue;
+					}
+				}
+				end_sequence();
+				out.push_back(s.front());
+				s.remove_prefix(1ull);
+			}
+			end_sequence();
+			return out;
+		}
+
+		/// @brief	Enables or disables colors, & renders the escape sequences from the palette.
+		void setActive(bool const state)
+		{
+			active = state;
+			for (size_t i{ 0ull }; i < sets.size(); ++i)
+				sets[i] = active ? combine(str::stringify(palette(static_cast<OUTCOLOR>(i)))) : std::string{};
+			reset = active ? combine(str::stringify(palette())) : std::string{};
+			separator = span(' ', (*this)(OUTCOLOR::OPERATOR), '=', reset, ' ');
+		}
+		bool isActive() const noexcept { return active; }
+
+		/// @brief	Returns the escape sequence that sets the given color.
+		std::string_view operator()(OUTCOLOR const c) const noexcept { return sets[static_cast<size_t>(c)]; }
+		/// @brief	Returns the escape sequence that resets the color.
+		std::string_view operator()() const noexcept { return reset; }
+		/// @brief	Returns the " = " between an input & its result.
+		std::string_view equals() const noexcept { return separator; }
+
+		/// @brief	Concatenates the given values into one string, combining adjacent escape sequences.
+		template<typename... Ts>
+		std::string span(Ts&&... segments) const
+		{
+			return combine(str::stringify(std::forward<Ts>(segments)...));
+		}
+
+		auto get_warn() const { return palette.get_warn(); }
+		auto get_error() const { return palette.get_error(); }
+	};
+	inline ColorSpans color;
 }
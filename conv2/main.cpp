@@ -1,24 +1,30 @@
 #include "version.h"
 #include "StreamFormatter.hpp"
+#include "BlockReader.hpp"
+#include "MappedFile.hpp"
+#include "OutputBuffer.hpp"
+#include "RecordWriter.hpp"
+#include "BinaryInput.hpp"
+#include "ColumnRewriter.hpp"
+#include "Modes.hpp"
 
 #include <TermAPI.hpp>
 #include <opt3.hpp>
 #include <palette.hpp>
 #include <hasPendingDataSTDIN.h>
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <charconv>
 
-#include <data.hpp>			// DATA
-#include <base.hpp>			// HEX
-#include <modulo.hpp>		// MODULO
-#include <length.hpp>		// LENGTH
-#include <ascii.hpp>		// ASCII
-#include <radians.hpp>		// RADIANS
-#include <FOV.hpp>			// FOV
-#include <bitwise.hpp>		// BITWISE
-#include <temperature.hpp>  // TEMPERATURE
-#include <exponents.hpp>	// POW / EXP
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include <range.hpp>		// FOV SWEEP / RANGE
+#include <format.hpp>		// FOV SWEEP / RANGE
 //#include <arithmetic.hpp>	// ARITHMETIC
 
 #include "operators.hpp"
@@ -45,230 +51,45 @@ public:
 				<< "  -q, --quiet             Only show minimal output." << '\n'
 				<< "  -g, --group             Use number grouping for large numbers. (Ex. 1,000,000)" << '\n'
 				<< "  -n, --no-color          Disable the usage of colorized output." << '\n'
+				<< "      --color             Use colorized output even when STDOUT isn't a terminal." << '\n'
+				<< "      --line-buffered     Write output after every line, instead of in large blocks. This is the default when" << '\n'
+				<< "                           writing to a terminal." << '\n'
 				<< "      --showbase          Force-show bases for numbers." << '\n'
 				<< "      --precision <#>     Specify the number of digits after the decimal point to show." << '\n'
 				<< "      --fixed             Force standard notation." << '\n'
 				<< "      --scientific        Force scientific notation." << '\n'
 				<< "      --hexfloat          Force floating-point numbers to use hexadecimal." << '\n'
+				<< "      --shortest          Print the shortest representation of floating-point numbers that round-trips exactly," << '\n'
+				<< "                           instead of using the precision. Can be combined with --fixed or --scientific." << '\n'
+				<< "      --range <RANGE>     Generate input values from \"start:stop[:step]\" instead of reading them. The parameters" << '\n'
+				<< "                           are then the input & output units. Supported by the unit, length, data, temperature, time," << '\n'
+				<< "                           & radians modes; radians mode units are \"deg\" or \"rad\"." << '\n'
+				<< "      --binary-in <FMT>   Read input values as a packed array of little-endian \"f64\", \"f32\", \"i64\", or \"u64\" values" << '\n'
+				<< "                           from STDIN, or from the file specified with \"--file <PATH>\". The parameters are the" << '\n'
+				<< "                           input & output units, as with --range." << '\n'
+				<< "      --column <COL>      Convert the values in one column of CSV text from STDIN, or from the file specified with" << '\n'
+				<< "                           \"--file <PATH>\", copying everything else through unchanged. COL is a column number" << '\n'
+				<< "                           starting at 1, or the name of a column in the header. The parameters are the input &" << '\n'
+				<< "                           output units, as with --range. Fields that aren't numbers are left as-is." << '\n'
+				<< "      --delimiter <CHAR>  The field delimiter used by --column. Defaults to ','; use \"tab\" for TSV." << '\n'
+				<< "      --binary-out <FMT>  Write results as a packed array of little-endian \"f64\", \"f32\", \"i64\", or \"u64\" values," << '\n'
+				<< "                           with no text formatting. Integer formats round floating-point results to the nearest integer." << '\n'
+				<< "      --binary-header     Start binary output with a header describing the value format & output fields." << '\n'
+				<< "      --format <FMT>      Write results as \"jsonl\" (one JSON object per line), \"csv\", or \"tsv\" records instead" << '\n'
+				<< "                           of text. CSV & TSV output starts with a header line containing the field names." << '\n'
 				<< '\n'
-				<< "MODES:\n"
-				<< "  -d, --data              Data Size Conversions. (B, kB, MB, GB, etc.)" << '\n'
-				<< "  -x, --hex               Hexadecimal <=> Decimal Conversions." << '\n'
-				// TODO: << "  -B, --base              Number representation base conversions. (Binary, Octal, Decimal, Hexadecimal)" << '\n'
-				<< "  -m, --mod               Modulo Calculator." << '\n'
-				<< "  -l, --len               Length Unit Conversions. (meters, feet, Bethesda-units, etc.)" << '\n'
-				<< "  -a, --ascii             ASCII Table Lookup Tool. Converts all characters to their ASCII values." << '\n'
-				<< "  -R, --rad               Degrees <=> Radians Converter." << '\n'
-				<< "  -F, --FOV <H:V>         Horizontal <=> Vertical Field of View Converter. Requires an aspect ratio, ex: \"16:9\"." << '\n'
-				<< "  -b, --bitwise           Perform bitwise calculations on binary, decimal, and/or hexadecimal numbers." << '\n'
-				<< "  -e, --exp, --pow        Exponent Calculator.  Use a comma ',' (shell) or semicolon ';' (string) between expressions." << '\n'
-				<< "  -t, --temp              Temperature Converter. Converts between Celcius, Kelvin, & Fahrenheit." << '\n'
-				;
+				<< "MODES:\n";
+			for (const auto& mode : MODES)
+				os << mode.help;
 		}
 		else { // scoped help
 			std::string subject{ h._param };
 			subject.erase(std::remove(subject.begin(), subject.end(), '-'), subject.end());
 
-			// temporary buffer
-			std::stringstream buffer;
-			buffer << "MODE:\n";
-			// DATA HELP
-			if (str::equalsAny(subject, "d", "data")) {
-				buffer
-					<< "  -d  --data              Data Size Conversions. (B, kB, MB, GB, etc.)" << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-d|--data> <<INPUT_UNIT> <VALUE> <OUTPUT_UNIT>>..." << '\n'
-					<< "                    <<VALUE> <INPUT_UNIT> <OUTPUT_UNIT>>..." << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< '\n'
-					<< "  Units can be specified with their symbol (ex: B, kB, MB, etc.) or full names (ex: byte, kilobyte, megabyte, etc.)." << '\n'
-					<< "  Unit symbols are case-sensitive while full names are case-insensitive." << '\n'
-					;
-			}
-			// HEXADECIMAL HELP
-			else if (str::equalsAny(subject, "x", "hex", "hexadecimal")) {
-				buffer
-					<< "  -x  --hex               Hexadecimal <=> Decimal Conversions." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-x|--hex> <VALUE>..."
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< "  All decimal inputs are converted to hexadecimal, and vice-versa." << '\n'
-					<< '\n'
-					<< "  Inputs are treated as hexadecimal if any of the following is true:" << '\n'
-					<< "    - It contains at least one alphabetic character in the range [A - F]. (case-insensitive)" << '\n'
-					<< "    - It is prefixed by \"0x\"." << '\n'
-					<< "  If neither of the above are true for an input, it is assumed to be in base-10." << '\n'
-					;
-			}
-			// BASE HELP
-			else if (str::equalsAny(subject, "B", "base")) {
-				buffer
-					<< "  -B  --base              Number representation base conversions. (Binary, Octal, Decimal, Hexadecimal)" << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-B|--base> < <<BASE>:<INPUT>> <BASE> >" << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< ""
-					;
-			}
-			// MODULO HELP
-			else if (str::equalsAny(subject, "m", "mod", "modulo")) {
-				buffer
-					<< "  -m  --mod               Modulo Calculator." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-m|--mod> <<NUMBER> <MOD>>..." << '\n'
-					<< "                   <<NUMBER>%<MOD>>..." << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< "  Inputs can either be in the format \"<NUMBER> <MOD>\" or without spaces as \"<NUMBER>%<MOD>\"."
-					;
-			}
-			// LENGTH HELP
-			else if (str::equalsAny(subject, "l", "len", "length")) {
-				buffer
-					<< "  -l  --len               Length Unit Conversions. (meters, feet, etc.)" << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-l|--len> <<INPUT_UNIT> <VALUE> <OUTPUT_UNIT>>..." << '\n'
-					<< "                   <<VALUE> <INPUT_UNIT> <OUTPUT_UNIT>>..." << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< "  Each conversion always uses 3 parameters, so the total number of parameters must be a multiple of 3." << '\n'
-					<< '\n'
-					<< "  Units can be specified with their symbol (ex: ft, m, Mm, etc.) or full names (ex: feet/foot, meter, megameter, etc.)." << '\n'
-					<< "  Unit symbols are case-sensitive while full names are case-insensitive." << '\n'
-					<< "  Both the American spelling \"meter\" and the British spelling \"metre\" are accepted." << '\n'
-					;
-			}
-			// ASCII HELP
-			else if (str::equalsAny(subject, "a", "asc", "ascii")) {
-				buffer
-					<< "  -a  --ascii             ASCII Table Lookup Tool. Converts all characters to their ASCII values." << '\n'
-					<< '\n'
-					<< "MODIFIERS:\n"
-					<< "  -N  --numeric           Force parameters that are entirely composed of digits to be" << '\n'
-					<< "                           converted to their numerical ASCII values." << '\n'
-					<< "  -s  --signed            Use signed range [-127 - 127] instead of unsigned range [0 - 255]" << '\n'
-					<< "                           when interpreting input values and printing output values." << '\n'
-					<< "      --linear            Print each conversion on a new line instead of using the table-style output." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-a|--ascii> [-N|--numeric] [-u|--unsigned] [--linear] <INPUT>..." << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< '\n'
-					<< "  By default, all inputs are converted to their numerical ASCII values -- including numbers." << '\n'
-					<< "  This behavior can be disabled with the \"--output-text\" modifier which changes this behavior" << '\n'
-					<< "  so that any entirely-numerical parameters in the range [-127 - 255] are" << '\n'
-					<< "  converted to their textual representations." << '\n'
-					;
-			}
-			// RADIANS HELP
-			else if (str::equalsAny(subject, "R", "rad", "radian", "radians")) {
-				buffer
-					<< "  -R  --rad               Degrees <=> Radians Converter." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-R|--rad> <<NUMBER>[c]>..." << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< '\n'
-					<< "  Inputs are assumed to be in Degrees unless the letter 'c' or 'r' is appended to them." << '\n'
-					;
-			}
-			// FOV HELP
-			else if (str::equalsAny(subject, "F", "FOV")) {
-				buffer
-					<< "  -F  --FOV <H:V>         Horizontal <=> Vertical Field of View Converter. Requires an aspect ratio, ex: \"16:9\"." << '\n'
-					<< '\n'
-					<< "MODIFIERS:\n"
-					<< "  -R  --rad               Use radians instead of degrees for input and output values." << '\n'
-					<< "  -r  --round             Rounds the resulting output to the nearest integer." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-F|--FOV> <<AspectHorizontal>:<AspectVertical>> <<INPUT>[H|V] ...>" << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< '\n'
-					<< "  Inputs may have an orientation specifier; either a 'V' for Vertical or 'H' for Horizontal." << '\n'
-					<< "  You can append the orientation specifier character to the number." << '\n'
-					<< "  If no orientation is specified, Horizontal is used by default." << '\n'
-					;
-			}
-			// BITWISE HELP
-			else if (str::equalsAny(subject, "b", "bitwise")) {
-				buffer
-					<< "  -b  --bitwise           Perform bitwise calculations on binary, decimal, and/or hexadecimal numbers." << '\n'
-					<< '\n'
-					<< "MODIFIERS:\n"
-					<< "      --binary            Print output values in binary (base-2) instead of decimal." << '\n'
-					<< "  -O  --octal             Print numbers in octal (base-8) instead of decimal." << '\n'
-					<< "  -x  --hex               Print numbers in hexadecimal (base-16) instead of decimal." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-b|--bitwise> [MODIFIER] '<NUMBER> <OPERATOR> <NUMBER>'" << '\n'
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< "  Note that bitwise expressions must be delimited with a comma (,) or semicolon (;) when using multiple" << '\n'
-					<< "   expressions in the same command." << '\n'
-					<< "  Nesting operations is fully supported, you can use parenthesis '()' to control order-of-operations." << '\n'
-					<< '\n'
-					<< "BITWISE SYNTAX:\n"
-					<< "  Most operations are composed of two input values (operands) and an operator. The only exception to this rule is" << '\n'
-					<< "   the 'NOT'/'~' operator, which requires only one operand." << '\n'
-					<< "  Each expression is composed of an operator, and two input values; Input values are assumed to be represented" << '\n'
-					<< "   in base-10 (decimal), unless prefixed with '0b' for base-2 (binary), or '0x' for base-16 (hexadecimal)." << '\n'
-					<< "  Example of the base-10 representation of `60` in binary and hex, using their respective prefixes:" << '\n'
-					<< '\n'
-					<< "       `0b111100`" << '\n'
-					<< "       `0x3C`" << '\n'
-					<< '\n'
-					<< "  The operator may be specified using literal operator names ( 'AND', 'OR', 'XOR', 'NOT' ), or the" << '\n'
-					<< "   standard symbols ( | ^ & ~ ). Most symbols must be escaped when used directly in the shell." << '\n'
-					<< "  This behavior is designed to support shell pipe operators, for example by using the `cat`" << '\n'
-					<< "   or `echo` commands in combination with the '|' pipe operator like so:" << '\n'
-					<< '\n'
-					<< "       `cat \"file\" | conv2 -bx`" << '\n'
-					;
-			}
-			// EXPONENT HELP
-			else if (str::equalsAny(subject, "e", "exp", "pow")) {
-				buffer
-					<< "  -e, --exp, --pow        Exponent Calculator.  Use a comma ',' (shell) or semicolon ';' (string) between expressions." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< "  Note that each successive expression must be seperated from the previous expression with a comma (,) when used" << '\n'
-					<< "   directly from the shell, or a semicolon (;) when enclosed by quotes (in most shells)." << '\n'
-					<< "  Nesting operations is fully supported, you can use parenthesis '()' to control order-of-operations." << '\n'
-					<< '\n'
-					<< "EXPONENT SYNTAX:\n"
-					<< "  Use a caret symbol (^) to seperate the exponent from the variable." << '\n'
-					<< "  Seperate multiple expressions with a comma (,) or semicolon (;)." << '\n'
-					<< "  To calculate the expression '5 to the power of 25 to the power of 2.', you would use:"
-					<< '\n'
-					<< "    5 ^ (25 ^ 2)" << '\n'
-					;
-			}
-			// TEMPERATURE HELP
-			else if (str::equalsAny(subject, "t", "temp", "temperature")) {
-				buffer
-					<< "  -t, --temp              Temperature system converter." << '\n'
-					<< '\n'
-					<< "USAGE:\n"
-					<< "  conv2 <-t|--temp>  <<<VALUE><INPUT_UNIT> <OUTPUT_UNIT>> ...>"
-					<< '\n'
-					<< "  Any uncaptured commandline parameters are used as input." << '\n'
-					<< "  You must seperate negative input values from the input unit with at least one space." << '\n';
-			}
-			else throw make_exception("Unrecognized help subject: \"", h._param, "\"!");
-			os << buffer.rdbuf();
+			const ModeDescriptor* const mode{ find_mode((subject.size() == 1ull ? "-" : "--") + subject) };
+			if (mode == nullptr || mode->help.empty())
+				throw make_exception("Unrecognized help subject: \"", h._param, "\"!");
+			os << "MODE:\n" << mode->help << mode->usage;
 		}
 		return os;
 	}
@@ -295,8 +116,12 @@ int main(const int argc, char** argv)
 	using conv2::OUTCOLOR;
 	using conv2::color;
 
-	// use a buffer to prevent changes to standard output
-	std::stringstream buffer;
+	std::ios_base::sync_with_stdio(false);
+
+	// all output is written to STDOUT through this buffer
+	OutputBuffer sink;
+	std::ostream buffer{ &sink };
+	bool trailingNewline{ true };
 	int returnCode = 1;
 
 	try {
@@ -304,25 +129,52 @@ int main(const int argc, char** argv)
 		opt3::ArgManager args{ argc, argv,
 			opt3::make_template(opt3::ConflictStyle::CapturesConflict, opt3::CaptureStyle::Optional, 'h', "help"),
 			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, 'F', "FOV"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "mod-by"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "file"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "sweep"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "range"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "binary-out"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "binary-in"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "format"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "column"),
+			opt3::make_template(opt3::ConflictStyle::Conflict, opt3::CaptureStyle::Required, "delimiter"),
 			'V'
 		};
+		// the mode is selected by the first argument
+		const ModeDescriptor* const mode{ find_mode(argc > 1 ? argv[1] : "") };
 
 		// handle blocking arguments
-		color.setActive(!args.check_any<opt3::Flag, opt3::Option>('n', "no-color"));
+		const bool noColor{ args.check_any<opt3::Flag, opt3::Option>('n', "no-color") };
+		conv2::palette.setActive(!noColor);
+		// escape sequences are only written to terminals, unless they were explicitly requested
+		color.setActive(!noColor && (args.check<opt3::Option>("color") || OutputBuffer::is_terminal(1)));
 		bool quiet{ args.check_any<opt3::Flag, opt3::Option>('q', "quiet") };
 		bool numGrouping{ args.check_any<opt3::Flag, opt3::Option>('g', "group") };
+		if (args.check<opt3::Option>("line-buffered"))
+			sink.setLineBuffered(true);
 
+		// [-h|--help] <MODE>
+		if (const auto& subject{ args.getv_any<opt3::Flag, opt3::Option>('h', "help") }; subject.has_value()) {
+			buffer << PrintHelp(subject) << std::flush;
+			return 0;
+		}
 		// [-h|--help]
-		if (args.empty() || args.check_any<opt3::Flag, opt3::Option>('h', "help"))
+		else if (args.empty() || args.check_any<opt3::Flag, opt3::Option>('h', "help"))
 			throw make_custom_exception<argument_exception>("No arguments were specified!");
 		// [-v|--version]
 		else if (args.check_any<opt3::Flag, opt3::Option>('v', "version")) {
-			std::cout << (quiet ? "" : "conv2  v") << CONV2_VERSION << std::endl;
+			buffer << (quiet ? "" : "conv2  v") << CONV2_VERSION << std::endl;
 			return 0;
 		}
 
+		// modes that read STDIN in blocks themselves
+		const bool streamingInput{ (mode != nullptr && mode->streaming) || args.check<opt3::Option>("mod-by") || args.check<opt3::Option>("file") || args.check<opt3::Option>("range") || args.check<opt3::Option>("binary-in") || args.check<opt3::Option>("column") };
+
+		// checked once, since reading STDIN below consumes it
+		const bool pendingInput{ hasPendingDataSTDIN() };
+
 		std::vector<std::string> parameters;
-		if (hasPendingDataSTDIN()) {
+		if (!streamingInput && pendingInput) {
 			const size_t& expand_by{ parameters.size() * 2 };
 			parameters.reserve(parameters.size() + expand_by);
 			std::string s;
@@ -339,308 +191,180 @@ int main(const int argc, char** argv)
 
 		StreamFormatter streamfmt{ &args };
 		buffer << streamfmt;
-
-		// DATA
-		if (const auto& dataArg{ args.get_any<opt3::Option, opt3::Flag>('d', "data") }; dataArg.has_value() && dataArg.value() == args.at(0)) {
-			for (std::vector<std::string>::const_iterator arg{ parameters.begin() }; arg != parameters.end(); ++arg) {
-				if (const auto conv{ data::Conversion(arg, parameters.end()) }; conv._in.has_value() && conv._out.has_value()) {
-					if (!quiet) { // print input values
-						const auto in{ conv._in.value().get() };
-						buffer
-							<< color(OUTCOLOR::INPUT) << in->_value << color()
-							<< ' ' << in->_type
-							<< color(OUTCOLOR::OPERATOR) << " = " << color();
-					}
-					const auto out{ conv._out.value().get() };
-					buffer
-						<< color(OUTCOLOR::OUTPUT) << out->_value << color()
-						<< ' ' << out->_type << '\n';
-				}
-			}
+		const auto& floatFormat{ conv::FloatFormat::from(buffer) };
+
+		const auto& binaryOut{ args.getv<opt3::Option>("binary-out") }, & formatArg{ args.getv<opt3::Option>("format") };
+		if (binaryOut.has_value() && formatArg.has_value())
+			throw make_exception("--binary-out & --format can't be used together!");
+		RecordWriter records{ sink, binaryOut.has_value() ? parse_binary_format(binaryOut.value()) : parse_record_format(formatArg.value_or("text")), floatFormat };
+		if (records.binary()) {
+			records.setBinaryHeader(args.check<opt3::Option>("binary-header"));
+		#ifdef _WIN32
+			_setmode(_fileno(stdout), _O_BINARY);
+		#endif
 		}
-		// HEX
-		else if (const auto& hexArg{ args.get_any<opt3::Option, opt3::Flag>('x', "hex", "hexadecimal") }; hexArg.has_value() && hexArg.value() == args.at(0)) {
-			for (const auto& it : parameters) {
-				if (!quiet)
-					buffer << color(OUTCOLOR::INPUT) << it << color() << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-				switch (base::detectBase(it, Base::DECIMAL | Base::HEXADECIMAL)) {
-				case Base::DECIMAL:
-					buffer << color(OUTCOLOR::OUTPUT) << "0x" << str::fromBase10(it, 16) << color() << '\n';
-					break;
-				case Base::HEXADECIMAL:
-					buffer << color(OUTCOLOR::OUTPUT) << str::toBase10(it, 16) << color() << '\n';
-					break;
-				case Base::ZERO: [[fallthrough]];
-				default:
-					throw make_exception("Invalid number: \"", it, "\"!");
-				}
-			}
+		if (records.enabled()) { // records are never colorized, & every record already ends with a newline
+			color.setActive(false);
+			trailingNewline = false;
 		}
-		// BASE
-		else if (const auto& baseArg{ args.get_any<opt3::Option, opt3::Flag>('B', "base") }; baseArg.has_value() && baseArg.value() == args.at(0)) {
-			const auto& splitArg{ [](const std::string& str) -> std::pair<int, std::string> {
-				int base{ 10 };
-				std::string value{ 0ll };
-				if (const auto& pos{ str.find(':') }; pos != std::string::npos) {
-					base = str::stoi(str.substr(0ull, pos));
-					value = str.substr(pos + 1ull);
-				}
-				else value = str;
-				return{ base, value };
-			} };
-
-			std::pair<int, std::string> in;
-			int outBase{ 10 };
-			// TODO: Finish base conversion mode
-			const auto& calculate{ [&in, &outBase]() {
-
-			} };
-
-			for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
 
+		// RANGE / BINARY INPUT / COLUMN
+		if (const auto& rangeArg{ args.getv<opt3::Option>("range") }, & binaryIn{ args.getv<opt3::Option>("binary-in") }, & columnArg{ args.getv<opt3::Option>("column") }; rangeArg.has_value() || binaryIn.has_value() || columnArg.has_value()) {
+			if (rangeArg.has_value() + binaryIn.has_value() + columnArg.has_value() != 1)
+				throw make_exception("Only one of --range, --binary-in, & --column can be used at a time!");
+			const std::string_view source{ rangeArg.has_value() ? "--range" : (binaryIn.has_value() ? "--binary-in" : "--column") };
+			if (columnArg.has_value() && records.enabled())
+				throw make_exception("--column writes delimited text; it can't be used with --format or --binary-out!");
+			const auto& units{ args.getv_all<opt3::Parameter>() };
+			if (units.size() != 2ull)
+				throw make_exception(source, " requires exactly 2 parameters; an input unit & an output unit!");
+
+			// the conversion, & the text that follows input & output values
+			if (mode == nullptr || mode->resolve == nullptr) {
+				std::string supported;
+				for (const auto& m : MODES) // by the longest name of each mode
+					if (m.resolve != nullptr)
+						supported.append(supported.empty() ? "" : ", ").append(*std::find_if(m.names.rbegin(), m.names.rend(), [](auto&& name) { return !name.empty(); }));
+				throw make_exception(source, " can only be used with these modes: ", supported, "!");
 			}
-		}
-		// MODULO
-		else if (const auto& modArg{ args.get_any<opt3::Option, opt3::Flag>('m', "mod", "modulo") }; modArg.has_value() && modArg.value() == args.at(0)) {
-			for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
-				std::string here{ *it }, next{ "" };
-				if (const auto& pos{ here.find('%') }; pos != std::string::npos) {
-					next = here.substr(pos + 1ull);
-					here = here.substr(0ull, pos);
+			const UnitPair unitPair{ mode->resolve(units[0], units[1]) };
+			const auto& transform{ unitPair.transform };
+			const auto& inName{ unitPair.inName }, & outName{ unitPair.outName }, & inUnit{ unitPair.inUnit }, & outUnit{ unitPair.outUnit };
+
+			// the parts of each line that never change
+			const std::string lineBegin{ quiet ? "" : std::string{ color(OUTCOLOR::INPUT) } };
+			const std::string lineMiddle{ quiet ? std::string{ color(OUTCOLOR::OUTPUT) } : color.span(color(), inUnit, color.equals(), color(OUTCOLOR::OUTPUT)) };
+			const std::string lineEnd{ color.span(color(), quiet ? "" : outUnit, '\n') };
+
+			constexpr size_t BLOCK_SIZE{ 4096ull };
+			// values are converted in the same precision as the transform; where long double has a 64-bit mantissa, this also holds every
+			//  64-bit integer read by --binary-in exactly, so converting i64 or u64 values to the same unit doesn't change them
+			std::vector<long double> inputs(BLOCK_SIZE), results(BLOCK_SIZE);
+			auto& out{ sink };
+			if (records.enabled())
+				records.header({ "input", "input_unit", "output", "output_unit" });
+
+			// writes a value with the output format; values too long for the buffer are rare, & take the slower path
+			const auto& append_number{ [&](long double const value) {
+				char* const text{ out.prepare(64ull) };
+				if (const char* end{ conv::format(text, text + 64, value, floatFormat) }; end != nullptr)
+					out.commit(static_cast<size_t>(end - text));
+				else out += conv::to_string(value, floatFormat);
+			} };
+			// converts & prints the first count values in inputs
+			const auto& process{ [&](size_t const count) {
+				conv::transform(transform, inputs.data(), results.data(), count);
+
+				if (records.binary())
+					records.write_block(results.data(), count);
+				else if (records.enabled()) for (size_t k{ 0ull }; k < count; ++k)
+					records.row(inputs[k], inName, results[k], outName);
+				else for (size_t k{ 0ull }; k < count; ++k) {
+					if (!quiet) {
+						out += lineBegin;
+						append_number(inputs[k]);
+					}
+					out += lineMiddle;
+					append_number(results[k]);
+					out += lineEnd;
 				}
-				else if (std::distance(it, parameters.end()) >= 1ll) {
-					next = *++it;
+			} };
+
+			if (columnArg.has_value()) {
+				char delimiter{ ',' };
+				if (const auto& delimiterArg{ args.getv<opt3::Option>("delimiter") }; delimiterArg.has_value()) {
+					if (const auto& d{ str::tolower(delimiterArg.value()) }; d == "tab" || d == "\\t")
+						delimiter = '\t';
+					else if (d.size() == 1ull && d.front() != '"' && d.front() != '\n')
+						delimiter = delimiterArg.value().front();
+					else throw make_exception("Invalid delimiter: \"", delimiterArg.value(), "\"; expected a single character or \"tab\"!");
 				}
-				else std::cerr << color.get_warn() << "Unmatched value: \"" << here << '\"' << std::endl;
-				if (!quiet)
-					buffer << color(OUTCOLOR::INPUT) << here << color() << ' ' << color(OUTCOLOR::OPERATOR) << '%' << color() << ' ' << color(OUTCOLOR::INPUT) << next << color() << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-				buffer << color(OUTCOLOR::OUTPUT);
-				switch (modulo::find_num_type(here, next)) {
-				case modulo::NumberType::FLOAT:
-					buffer << modulo::Calculate(str::stold(here), str::stold(next)).getResult();
-					break;
-				case modulo::NumberType::INT:
-					buffer << modulo::Calculate(str::stoll(here), str::stoll(next)).getResult();
-					break;
+				ColumnRewriter rewriter{ out, delimiter, columnArg.value() };
+				// converts one field; returns false when it isn't a number
+				const auto& convert{ [&](std::string_view value) {
+					if (value.starts_with('+'))
+						value.remove_prefix(1ull);
+					long double v;
+					if (const auto& [ptr, ec] { std::from_chars(value.data(), value.data() + value.size(), v) }; ec != std::errc{} || ptr != value.data() + value.size())
+						return false;
+					append_number(transform(v));
+					return true;
+				} };
+				const auto& rewrite_stream{ [&](std::FILE* fp) {
+					std::vector<char> in(1ull << 16);
+					for (size_t n{ std::fread(in.data(), 1ull, in.size(), fp) }; n != 0ull; n = std::fread(in.data(), 1ull, in.size(), fp))
+						rewriter.feed({ in.data(), n }, convert);
+				} };
+
+				if (const auto& filePath{ args.getv<opt3::Option>("file") }; !filePath.has_value() || filePath.value() == "-")
+					rewrite_stream(stdin);
+				else if (const MappedFile file{ filePath.value() }; file.is_mapped())
+					rewriter.feed({ reinterpret_cast<const char*>(file.data()), file.size() }, convert);
+				else if (std::FILE* fp{ std::fopen(filePath.value().c_str(), "rb") }; fp != nullptr) {
+					rewrite_stream(fp);
+					std::fclose(fp);
 				}
-				buffer << color() << '\n';
+				else throw make_exception("Failed to open file \"", filePath.value(), "\"!");
+				rewriter.finish(convert);
+				trailingNewline = false; //< the output ends the same way as the input
 			}
-		}
-		// LENGTH
-		else if (const auto& lengthArg{ args.get_any<opt3::Option, opt3::Flag>('l', "len", "length") }; lengthArg.has_value() && lengthArg.value() == args.at(0)) {
-			const auto& is_value{ [](const std::string_view& str) -> bool {
-				return std::all_of(str.begin(), str.end(), [](auto&& c) {return isdigit(c) || c == '.' || c == '-'; });
-			} };
-			const auto& get_tuple{ [&is_value](auto&& it) {
-				const auto fst{ *it };
-				const auto snd{ *++it };
-				const auto thr{ *++it };
-				if (is_value(snd))
-					return std::make_tuple(fst, snd, thr);
-				else return std::make_tuple(snd, fst, thr);
-			} };
-			for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
-				if (std::distance(it, parameters.end()) >= 2ll) {
-					const auto& [in_unit, value, out_unit] { length::Convert(get_tuple(it))._vars };
-					const auto result{ length::Convert::getResult(in_unit, value, out_unit) };
-					if (!quiet) buffer << color(OUTCOLOR::INPUT) << value << color() << ' ' << in_unit << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-					buffer << color(OUTCOLOR::OUTPUT) << result << color();
-					if (!quiet) buffer << ' ' << out_unit;
-					buffer << '\n';
+			else if (rangeArg.has_value()) {
+				const auto& sweep{ conv::parse_range<long double>(rangeArg.value()) };
+				for (size_t i{ 0ull }, total{ sweep.size() }; i < total; i += BLOCK_SIZE) {
+					const size_t count{ std::min(BLOCK_SIZE, total - i) };
+					for (size_t k{ 0ull }; k < count; ++k)
+						inputs[k] = sweep[i + k];
+					process(count);
 				}
 			}
-		}
-		// ASCII
-		else if (const auto& asciiArg{ args.get_any<opt3::Option, opt3::Flag>('a', "asc", "ascii") }; asciiArg.has_value() && asciiArg.value() == args.at(0)) {
-			const bool&
-				disallowReverseConversion{ args.check_any<opt3::Flag, opt3::Option>('N', "numeric") },
-				signedRange{ args.check_any<opt3::Flag, opt3::Option>('s', "signed") },
-				onePerLine{ args.check_any<opt3::Flag, opt3::Option>("linear") };
-
-			for (auto it{ parameters.begin() }; it != parameters.end(); ++it) {
-				// Allow Reverse Lookup:
-				if (!disallowReverseConversion && std::all_of(it->begin(), it->end(), isdigit)) {
-					if (!quiet)
-						buffer << color(OUTCOLOR::INPUT) << *it << color() << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-					int n{ str::stoi(*it) };
-					// loopback
-					if (n > 127) n = -127 + n % 127;
-					const char c{ static_cast<char>(n) };
-					buffer << color(OUTCOLOR::OUTPUT) << c << color() << ' ';
-				}
-				// One Per Line Mode:
-				else if (onePerLine) {
-					for (const auto& c : *it) {
-						if (!quiet)
-							buffer << color(OUTCOLOR::INPUT) << c << color() << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-						buffer << color(OUTCOLOR::OUTPUT) << (signedRange ? static_cast<signed short>(static_cast<signed char>(c)) : static_cast<unsigned short>(static_cast<unsigned char>(c))) << color() << '\n';
+			else {
+				const RecordFormat format{ parse_binary_format(binaryIn.value()) };
+				const size_t valueSize{ binary_value_size(format) };
+				// decodes & processes whole values; returns the number of bytes that were used
+				const auto& decode{ [&](const unsigned char* data, size_t const size) {
+					const size_t total{ size / valueSize };
+					for (size_t i{ 0ull }; i < total; i += BLOCK_SIZE) {
+						const size_t count{ std::min(BLOCK_SIZE, total - i) };
+						decode_binary(format, data + i * valueSize, count, inputs.data());
+						process(count);
 					}
-				}
-				// Table Mode:
-				else if (!quiet) {
-					const size_t len{ it->size() };
-					std::vector<std::string> output;
-					output.reserve(len);
-					buffer << color(OUTCOLOR::OPERATOR) << '{' << color() << ' ';
-					for (const auto& c : *it) {
-						const auto& out{ std::to_string((signedRange ? static_cast<signed short>(static_cast<signed char>(c)) : static_cast<unsigned short>(static_cast<unsigned char>(c)))) };
-						output.emplace_back(out);
-						buffer << color(OUTCOLOR::INPUT) << c << color() << indent(out.size() + 1ull);
+					return total * valueSize;
+				} };
+				const auto& decode_stream{ [&](std::FILE* fp) {
+					std::vector<unsigned char> in(BLOCK_SIZE * valueSize * 16ull);
+					size_t carry{ 0ull };
+					for (size_t n{ std::fread(in.data(), 1ull, in.size(), fp) }; n != 0ull; n = std::fread(in.data() + carry, 1ull, in.size() - carry, fp)) {
+						n += carry;
+						const size_t used{ decode(in.data(), n) };
+						carry = n - used;
+						std::memmove(in.data(), in.data() + used, carry);
 					}
-					buffer << color(OUTCOLOR::OPERATOR) << '}' << color() << '\n' << color(OUTCOLOR::OPERATOR) << '{' << color() << ' ';
-
-					for (size_t i{ 0ull }, vecLen{ output.size() }; i < len && i < vecLen; ++i)
-						buffer << color(OUTCOLOR::OUTPUT) << output.at(i) << color() << ' ';
-					buffer << color(OUTCOLOR::OPERATOR) << '}' << color();
+					return carry;
+				} };
+
+				size_t remainder{ 0ull };
+				if (const auto& filePath{ args.getv<opt3::Option>("file") }; !filePath.has_value() || filePath.value() == "-") {
+				#ifdef _WIN32
+					_setmode(_fileno(stdin), _O_BINARY);
+				#endif
+					remainder = decode_stream(stdin);
 				}
-				// Quiet Non-Linear Mode:
-				else for (const auto& c : *it)
-					buffer << color(OUTCOLOR::OUTPUT) << (signedRange ? static_cast<signed short>(static_cast<signed char>(c)) : static_cast<unsigned short>(static_cast<unsigned char>(c))) << color() << ' ';
-				if (!onePerLine) buffer << '\n';
-			}
-		}
-		// RADIANS
-		else if (const auto& radianArg{ args.get_any<opt3::Option, opt3::Flag>('R', "rad", "radians") }; radianArg.has_value() && radianArg.value() == args.at(0)) {
-			for (const auto& it : parameters) {
-				std::string lower{ str::tolower(it) };
-
-				const bool in_radians{ str::endsWith(lower, 'c') || str::endsWith(lower, 'r') || str::endsWith(lower, "rad") };
-				lower.erase(std::remove_if(lower.begin(), lower.end(), isalpha), lower.end());
-
-				const auto v{ str::stold(lower) };
-				if (!quiet) {
-					buffer << color(OUTCOLOR::INPUT) << v << color() << ' ';
-					if (in_radians)
-						buffer << "rad";
-					else
-						buffer << "deg";
-					buffer << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
+				else if (const MappedFile file{ filePath.value() }; file.is_mapped())
+					remainder = file.size() - decode(file.data(), file.size());
+				else if (std::FILE* fp{ std::fopen(filePath.value().c_str(), "rb") }; fp != nullptr) {
+					remainder = decode_stream(fp);
+					std::fclose(fp);
 				}
-				if (in_radians)
-					buffer << color(OUTCOLOR::OUTPUT) << toDegrees(v) << color() << ' ' << "deg" << '\n';
-				else
-					buffer << color(OUTCOLOR::OUTPUT) << toRadians(v) << color() << ' ' << "rad" << '\n';
-			}
-		}
-		// FOV
-		else if (const auto& fovArg{ args.get_any<opt3::Option, opt3::Flag>('F', "FOV") }; fovArg.has_value() && fovArg.value() == args.at(0)) {
-			const auto& fov{ args.getv_any<opt3::Flag, opt3::Option>('F', "FOV") };
-			const bool& radians{ args.check_any<opt3::Flag, opt3::Option>('R', "rad") },
-				& round{ args.check_any<opt3::Flag, opt3::Option>('r', "round") };
+				else throw make_exception("Failed to open file \"", filePath.value(), "\"!");
 
-			if (!fov.has_value())
-				throw make_exception("Detected mode: FOV\n", indent(10), "No aspect ratio was specified!");
-
-			FOV::AspectRatio aspect{ 0, 0 };
-
-			std::string captured{ fov.value() };
-			if (const auto& pos{ captured.find(':') }; pos != std::string::npos) {
-				aspect.h = str::stoui(captured.substr(0ull, pos));
-				aspect.v = str::stoui(captured.substr(pos + 1ull));
-			}
-			else throw make_exception("Invalid aspect ratio specifier: \"", fov.value(), "\"!\n", indent(10), "Aspect ratios must be in the format \"Horizontal:Vertical\".");
-
-			for (std::string it : parameters) {
-				bool vertical{ str::endsWith(str::toupper(it), 'V') };
-				it.erase(std::remove_if(it.begin(), it.end(), isalpha), it.end());
-				if (!quiet)
-					buffer << color(OUTCOLOR::INPUT) << it << color() << (radians ? " rad" : "") << ' ' << (vertical ? 'V' : 'H') << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-
-				FOV::value const& in{ str::stold(it) };
-
-				FOV::value out{ 0.0L };
-
-				if (radians) {
-					if (vertical)
-						out = FOV::toHorizontalR(in, aspect);
-					else
-						out = FOV::toVerticalR(in, aspect);
-					buffer << color(OUTCOLOR::OUTPUT) << (round ? std::round(out) : out) << color() << " rad" << ' ' << (vertical ? 'H' : 'V') << '\n';
-				}
-				else {
-					if (vertical)
-						out = FOV::toHorizontal(in, aspect);
-					else
-						out = FOV::toVertical(in, aspect);
-					buffer << color(OUTCOLOR::OUTPUT) << (round ? std::round(out) : out) << color() << ' ' << (vertical ? 'H' : 'V') << '\n';
-				}
+				if (remainder != 0ull)
+					throw make_exception("Input ends with a partial value; ", remainder, " trailing byte", (remainder == 1ull ? " was" : "s were"), " ignored!");
 			}
 		}
-		// BITWISE
-		else if (const auto& bitwiseArg{ args.get_any<opt3::Option, opt3::Flag>('b', "bitwise") }; bitwiseArg.has_value() && bitwiseArg.value() == args.at(0)) {
-
-			bool binary{ false }; // no fmtflag for binary
-			std::ios_base& (*fmtFunction)(std::ios_base&) = &std::dec;
-			if (args.check_any<opt3::Flag, opt3::Option>('O', "octal"))
-				fmtFunction = &std::oct;
-			else if (args.check_any<opt3::Flag, opt3::Option>('x', "hex"))
-				fmtFunction = &std::hex;
-			else if (args.check_any<opt3::Flag, opt3::Option>('B', "binary"))
-				binary = true;
-
-			for (const auto& expr : [/*&valid_operand, &valid_operator, &match_cfg*/](auto&& params) {
-				std::vector<std::string> vec;
-					vec.reserve(params.size());
-					std::string buf;
-					buf.reserve(64ull);
-					for (auto it{ params.begin() }; it != params.end(); ++it) {
-						if (str::endsWithAny(*it, ',', ';')) {
-							vec.emplace_back(buf + it->substr(0ull, it->size() - 2ull));
-								buf.clear();
-						}
-						else if (std::distance(it, params.end()) == 1) {
-							vec.emplace_back(buf + *it);
-							buf.clear();
-						}
-						//else if (const bool has_operator{ std::regex_match(*it, valid_operator, match_cfg) }, has_operand{ std::regex_match(*it, valid_operand, match_cfg) }; has_operator && has_operand) { // whole expression
-						//	vec.emplace_back(*it);
-						//}
-						else buf += *it;
-					}
-				vec.shrink_to_fit();
-				return vec;
-			}(parameters)) {
-				bitwise::operation oper{ bitwise::parse(expr) };
-				if (!quiet)
-					buffer << oper << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-				buffer << color(OUTCOLOR::OUTPUT);
-				if (binary)
-					buffer << str::fromBase10(oper.result(), 2);
-				else
-					buffer << fmtFunction << oper.result();
-				buffer << color() << '\n';
-			}
-		}
-		// EXP / POW
-		else if (const auto& powArg{ args.get_any<opt3::Option, opt3::Flag>('e', "exp", "pow") }; powArg.has_value() && powArg.value() == args.at(0)) {
-			std::stringstream ss;
-			if (hasPendingDataSTDIN())
-				ss << std::cin.rdbuf();
-			if (const auto& params{ args.getv_all<opt3::Parameter>() }; !params.empty())
-				ss << str::join(params, ' ');
-			const auto& expressions{ str::split_all(ss.str(), ",;") };
-
-			if (expressions.empty())
-				throw make_exception("No exponent expressions were specified!");
-
-			for (const auto& expr : expressions)
-				std::cout << exponents::getOperationResult(expr, quiet).first << std::endl;
-		}
-		// TEMPERATURE
-		else if (const auto& tempArg{ args.get_any<opt3::Option, opt3::Flag>('t', "temp", "temperature") }; tempArg.has_value() && tempArg.value() == args.at(0)) {
-			const std::vector<std::string>& params{ args.getv_all<opt3::Parameter>() };
-
-			const auto& conversions{ conv::temperature_parse_arguments<long double>(params) };
-
-			using conv2::color;
-			for (const auto& conversion : conversions) {
-				const auto& result{ conversion.getResult() };
-				std::cout
-					<< color(OUTCOLOR::INPUT) << conversion.temperature_value.value << color() << conv::getTemperatureSystemSymbol(conversion.temperature_value.system)
-					<< color(OUTCOLOR::OPERATOR) << " = " << color()
-					<< color(OUTCOLOR::OUTPUT) << result.value << color() << conv::getTemperatureSystemSymbol(result.system)
-					<< '\n';
-			}
+		// MODES
+		else if (mode != nullptr) {
+			ModeRunner runner{ args, parameters, buffer, sink, records, floatFormat, quiet, streamingInput && pendingInput, trailingNewline };
+			(runner.*mode->run)();
 		}
 		else throw make_custom_exception<argument_exception>("Nothing to do; no mode was specified!");
 
@@ -651,8 +375,10 @@ int main(const int argc, char** argv)
 		std::cerr << color.get_error() << "An undefined exception occurred!" << std::endl;
 	}
 
-	// print buffer before exit
-	std::cout << buffer.rdbuf() << std::endl;
+	// flush the buffer before exit
+	if (trailingNewline)
+		buffer << '\n';
+	buffer.flush();
 
 	return returnCode;
 }
@@ -7,6 +7,7 @@
 #include "globals.h"
 
 #include <bitwise.hpp>
+#include <exponents.hpp>
 
 namespace bitwise {
 	inline std::ostream& operator<<(std::ostream& os, const operation& op)
@@ -38,65 +39,38 @@ namespace bitwise {
 	}
 }
 namespace exponents {
-	INLINE std::pair<std::string, std::string> getOperationResult(std::string const& rawInput, const bool quiet)
+	inline std::ostream& operator<<(std::ostream& os, const expression& expr)
 	{
 		using conv2::OUTCOLOR;
 		using conv2::color;
 
-		static const std::regex rgxParseOperation{ "(?:\\({0,1}?\\s*([\\s\\d\\^]+)\\s*\\){0,1})\\s*\\^\\s*(?:\\({0,1}\\s*([\\s\\d\\^]+)\\s*\\){0,1})", std::regex_constants::optimize };
-		std::smatch matches;
-
-		if (!std::regex_search(rawInput, matches, rgxParseOperation))
-			throw make_exception("Unrecognized operation syntax '", rawInput, "'");
-
-		if (!matches[1].matched && !matches[2].matched)
-			throw make_exception("Missing operand and exponent in '", rawInput, "'");
-		else if (!matches[1].matched)
-			throw make_exception("Missing operand in '", rawInput, "'");
-		else if (!matches[2].matched)
-			throw make_exception("Missing exponent in '", rawInput, "'");
-
-		std::string num{ str::trim(matches[1].str()) }, exp{ str::trim(matches[2].str()) };
-		std::string numEq, expEq;
-
-		// resolve sub-expressions, if necessary
-		if (num.find('^') != std::string::npos) {
-			const auto& [eq, result] {getOperationResult(num, quiet) };
-			numEq = eq;
-			num = result;
-		}
-		if (exp.find('^') != std::string::npos) {
-			const auto& [eq, result] { getOperationResult(exp, quiet) };
-			expEq = eq;
-			exp = result;
-		}
-
-		std::string result{ Pow(num, exp).getResultString() };
-		std::stringstream ss;
-
-		if (!quiet) {
-			// NUMBER:
-			if (numEq.empty())
-				ss << color(OUTCOLOR::INPUT) << num << color();
-			else {
-				ss << color(OUTCOLOR::HIGHLIGHT) << '(' << color();
-				ss << color(OUTCOLOR::INPUT) << numEq << color();
-				ss << color(OUTCOLOR::HIGHLIGHT) << ')' << color();
-			}
-			// CARET:
-			ss << ' ' << color(OUTCOLOR::OPERATOR) << '^' << color() << ' ';
-			// EXPONENT:
-			if (expEq.empty())
-				ss << color(OUTCOLOR::INPUT) << exp << color();
-			else {
-				ss << color(OUTCOLOR::HIGHLIGHT) << '(' << color();
-				ss << color(OUTCOLOR::INPUT) << expEq << color();
-				ss << color(OUTCOLOR::HIGHLIGHT) << ')' << color();
+		const auto& print{ [&os, &expr](auto&& self, size_t const index) -> void {
+			const auto& n{ expr.nodes[index] };
+			if (n.enclosed && index != expr.root)
+				os << color(OUTCOLOR::HIGHLIGHT) << '(' << color();
+			switch (n.type) {
+			case expression::NodeType::VALUE:
+				os << color(OUTCOLOR::INPUT) << n.text << color();
+				break;
+			case expression::NodeType::NEGATE:
+				os << color(OUTCOLOR::OPERATOR) << '-' << color();
+				self(self, n.left);
+				break;
+			case expression::NodeType::POW:
+				self(self, n.left);
+				os << ' ' << color(OUTCOLOR::OPERATOR) << '^' << color() << ' ';
+				self(self, n.right);
+				break;
+			case expression::NodeType::MOD:
+				self(self, n.left);
+				os << ' ' << color(OUTCOLOR::OPERATOR) << '%' << color() << ' ';
+				self(self, n.right);
+				break;
 			}
-			// EQUALS:
-			ss << ' ' << color(OUTCOLOR::OPERATOR) << '=' << color() << ' ';
-		}
-		ss << color(OUTCOLOR::OUTPUT) << result << color();
-		return { ss.str(), result };
+			if (n.enclosed && index != expr.root)
+				os << color(OUTCOLOR::HIGHLIGHT) << ')' << color();
+		} };
+		print(print, expr.root);
+		return os;
 	}
 }
@@ -0,0 +1,348 @@
+/**
+ * @file	check.cpp
+ * @author	radj307
+ * @brief	Self-check for convlib's exact arithmetic & batch kernels, run by ctest. Prints every check that fails, & returns non-zero if any did.
+ */
+#include <ascii.hpp>
+#include <bigint.hpp>
+#include <FOV.hpp>
+#include <format.hpp>
+#include <modulo.hpp>
+#include <range.hpp>
+#include <rational.hpp>
+#include <temperature.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	using sizes = std::initializer_list<size_t>;
+
+	int failures{ 0 };
+
+	void check(bool const ok, const char* what, size_t const a = 0ull, size_t const b = 0ull)
+	{
+		if (ok)
+			return;
+		++failures;
+		std::printf("FAILED: %s (%zu, %zu)\n", what, a, b);
+	}
+	void check(bool const ok, const char* what, std::string_view const detail)
+	{
+		if (ok)
+			return;
+		++failures;
+		std::printf("FAILED: %s (%.*s)\n", what, static_cast<int>(detail.size()), detail.data());
+	}
+
+	/// @brief	Returns a magnitude with n limbs. When saturated, every limb is 0xFFFFFFFF, which carries through every addition.
+	bigint::magnitude make_magnitude(std::mt19937& rng, size_t const n, bool const saturated)
+	{
+		bigint::magnitude m(n);
+		for (auto& limb : m)
+			limb = saturated ? 0xFFFFFFFFu : static_cast<bigint::limb>(rng());
+		if (!m.empty() && m.back() == 0)
+			m.back() = 1u;
+		return m;
+	}
+
+	/// @brief	Returns true when q * v + r == u & r < v.
+	bool division_holds(bigint::magnitude const& u, bigint::magnitude const& v, bigint::magnitude const& q, bigint::magnitude const& r)
+	{
+		bigint::magnitude product{ bigint::detail::mul(q, v) };
+		bigint::detail::add_to(product, r);
+		bigint::detail::trim(product);
+		return product == u && bigint::detail::compare(r, v) < 0;
+	}
+
+	// BIGINT
+	void check_bigint()
+	{
+		using bigint::KARATSUBA_THRESHOLD;
+		std::mt19937 rng{ 307u };
+
+		// Karatsuba must match the schoolbook product on both sides of the threshold, with balanced & unbalanced splits
+		for (const size_t an : sizes{ KARATSUBA_THRESHOLD - 1, KARATSUBA_THRESHOLD, KARATSUBA_THRESHOLD + 1, 2 * KARATSUBA_THRESHOLD + 1, 5 * KARATSUBA_THRESHOLD + 3 }) {
+			for (const size_t bn : sizes{ 1ull, KARATSUBA_THRESHOLD - 1, KARATSUBA_THRESHOLD, KARATSUBA_THRESHOLD + 1, an }) {
+				for (const bool saturated : { true, false }) {
+					const auto& a{ make_magnitude(rng, an, saturated) }, & b{ make_magnitude(rng, bn, saturated) };
+					check(bigint::detail::mul(a, b) == bigint::detail::mul_schoolbook(a.data(), a.size(), b.data(), b.size()), "Karatsuba product", an, bn);
+				}
+			}
+		}
+
+		// Algorithm D; each of these needs the add-back step (from Hacker's Delight, divmnu64.c)
+		const std::initializer_list<std::pair<bigint::magnitude, bigint::magnitude>> ADD_BACK{
+			{ { 3u, 0u, 0x80000000u, 1u }, { 1u, 0u, 0x20000000u } },
+			{ { 3u, 0u, 0x00008000u, 1u }, { 1u, 0u, 0x00002000u } },
+			{ { 0u, 0u, 0x00008000u, 0x00007FFFu }, { 1u, 0u, 0x00008000u } },
+			{ { 0u, 0x0000FFFEu, 0u, 0x00008000u }, { 0x0000FFFFu, 0u, 0x00008000u } },
+			{ { 0u, 0xFFFFFFFEu, 0u, 0x80000000u }, { 0xFFFFFFFFu, 0u, 0x80000000u } },
+			{ { 0u, 0u, 0x80000000u, 0x7FFFFFFFu }, { 1u, 0u, 0x80000000u } },
+		};
+		size_t i{ 0ull };
+		for (const auto& [u, v] : ADD_BACK) {
+			bigint::magnitude q, r;
+			bigint::detail::divmod(u, v, q, r);
+			check(division_holds(u, v, q, r), "Algorithm D add-back", i++);
+		}
+
+		// division must undo multiplication, & leave a remainder below the divisor
+		for (const size_t un : sizes{ 2ull, 3ull, 8ull, KARATSUBA_THRESHOLD + 5, 3 * KARATSUBA_THRESHOLD }) {
+			for (const size_t vn : sizes{ 2ull, 3ull, 7ull, KARATSUBA_THRESHOLD + 1 }) {
+				for (const bool saturated : { true, false }) {
+					const auto& u{ make_magnitude(rng, un, saturated) }, & v{ make_magnitude(rng, vn, saturated) };
+					bigint::magnitude q, r;
+					bigint::detail::divmod(u, v, q, r);
+					check(division_holds(u, v, q, r), "division", un, vn);
+					bigint::detail::divmod(bigint::detail::mul(u, v), v, q, r);
+					check(q == u && r.empty(), "division of a product", un, vn);
+				}
+			}
+		}
+
+		// the signed wrapper
+		const auto& big{ bigint::integer::parse("-340282366920938463463374607431768211457") }; //< -(2^128 + 1)
+		check((big * big) / big == big && (big * big) % big == bigint::integer{}, "integer division");
+		check((big % bigint::integer{ 7 }).to_string() == "-5", "integer remainder sign");
+	}
+
+	// MODULO
+	void check_divisor()
+	{
+		using limits = std::numeric_limits<modulo::IntT>;
+		std::mt19937_64 rng{ 307u };
+		std::vector<modulo::IntT> divisors{ 1, -1, 2, 3, 7, -10, 641, 1000000007, (1ll << 62) + 1, limits::max(), limits::min() + 1 };
+		for (int i{ 0 }; i < 64; ++i)
+			divisors.push_back(static_cast<modulo::IntT>(rng() >> (rng() % 63u)) | 1);
+
+		// the block kernel uses AVX2 when the CPU supports it, & must match the scalar remainder exactly
+		std::vector<modulo::IntT> in(1027ull), out(in.size());
+		for (const auto& divisor : divisors) {
+			for (auto& value : in)
+				value = static_cast<modulo::IntT>(rng()) >> (rng() % 64u);
+			in[0] = limits::min();
+			in[1] = limits::max();
+			in[2] = 0;
+			in[3] = -1;
+			const modulo::Divisor d{ divisor };
+			d.remainder(in.data(), out.data(), in.size());
+			for (size_t i{ 0ull }; i < in.size(); ++i)
+				check(out[i] == d.remainder(in[i]) && (in[i] == limits::min() || out[i] == in[i] % divisor), "Divisor block remainder", static_cast<size_t>(divisor), i);
+		}
+	}
+
+	// FORMAT
+	void check_format()
+	{
+		using Notation = conv::FloatFormat::Notation;
+		char buf[64];
+		const auto& formats{ [&buf](double const value, conv::FloatFormat const& fmt, std::string_view const expected) {
+			const char* end{ conv::format(buf, buf + sizeof(buf), value, fmt) };
+			check(end != nullptr && std::string_view(buf, static_cast<size_t>(end - buf)) == expected, "format", expected);
+		} };
+		formats(1.1e-5, { Notation::General, 6 }, "1.1e-05");
+		formats(0.000123456, { Notation::General, 3 }, "0.000123");
+		formats(-49.5, { Notation::General, 6 }, "-49.5");
+		// output that doesn't fit in the buffer is an error, in every notation
+		check(conv::format(buf, buf + sizeof(buf), 1.1e-5, { Notation::General, 80 }) == nullptr, "format general buffer size");
+		check(conv::format(buf, buf + 4, 123456.0, { Notation::General, 6 }) == nullptr, "format general buffer size");
+		check(conv::format(buf, buf + sizeof(buf), 1e60, { Notation::Fixed, 6 }) == nullptr, "format fixed buffer size");
+	}
+
+	// RANGE
+	void check_range()
+	{
+		const auto& valid{ [](std::string_view const s) {
+			try {
+				(void)conv::parse_range<double>(s);
+				return true;
+			} catch (std::exception const&) {
+				return false;
+			}
+		} };
+		check(conv::parse_range<double>("0:1:0.25").size() == 5ull, "range size");
+		check(conv::parse_range<double>("1:-1:-1").size() == 3ull, "range size");
+		check(conv::parse_range<long double>("0:0.3:0.1").size() == 4ull, "range size");
+		for (std::string_view const s : { "0:1:nan", "0:1:inf", "0:inf", "nan:1", "0:1e30", "0:1:1e-300", "-1e308:1e308", "0:1:0", "1:0" })
+			check(!valid(s), "range rejected", s);
+		check(conv::range<double>{ 0.0, 1.0, std::numeric_limits<double>::quiet_NaN() }.size() == 0ull, "range size of NaN step");
+	}
+
+	// FOV
+	/// @brief	Returns the distance between two doubles in units in the last place, or 0 when both are NaN.
+	double ulps(double const a, double const b)
+	{
+		if (std::isnan(a) || std::isnan(b))
+			return std::isnan(a) && std::isnan(b) ? 0.0 : std::numeric_limits<double>::infinity();
+		if (a == b)
+			return 0.0;
+		return std::fabs(a - b) / (std::nextafter(std::fabs(b), std::numeric_limits<double>::infinity()) - std::fabs(b));
+	}
+
+	/// @brief	Checks the FOV batch kernels, which use AVX2 when the CPU supports it, against std::tan & std::atan.
+	void check_fov()
+	{
+		std::mt19937_64 rng{ 307u };
+		std::uniform_real_distribution<double> angles{ -1'000.0, 1'000.0 }, large{ -1e10, 1e10 };
+		std::vector<double> inputs(100'003ull), tangents(inputs.size()), results(inputs.size());
+		for (size_t i{ 0ull }; i < inputs.size(); ++i)
+			inputs[i] = i % 8ull == 0ull ? large(rng) : angles(rng);
+		for (double const v : { 0.0, -0.0, 90.0, 180.0, 360.0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() })
+			inputs.emplace_back(v);
+		tangents.resize(inputs.size());
+		results.resize(inputs.size());
+
+		// only the first mismatch of each kernel is printed
+		const auto& check_all{ [](std::vector<double> const& in, std::vector<double> const& out, auto&& expected, const char* what) {
+			size_t mismatches{ 0ull };
+			for (size_t i{ 0ull }; i < in.size(); ++i)
+				if (ulps(out[i], expected(in[i])) > 4.0 && mismatches++ == 0ull)
+					check(false, what, std::to_string(in[i]));
+			check(mismatches == 0ull, what, mismatches);
+		} };
+		for (bool const radians : { false, true }) {
+			const double scale{ radians ? 0.5 : M_PI / 360.0 };
+			FOV::half_tangents(inputs.data(), tangents.data(), inputs.size(), radians);
+			check_all(inputs, tangents, [scale](double const v) { return std::tan(v * scale); }, "FOV half_tangents");
+			FOV::convert_tangents(tangents.data(), results.data(), tangents.size(), 9.0 / 16.0, radians);
+			check_all(tangents, results, [radians](double const t) { return std::atan(t * (9.0 / 16.0)) * (radians ? 2.0 : 360.0 / M_PI); }, "FOV convert_tangents");
+		}
+	}
+
+	// ASCII
+	/// @brief	Checks that UTF-8 decoding is the same when runs of ASCII are widened by the SIMD fast path.
+	void check_ascii()
+	{
+		std::string input;
+		for (size_t i{ 0ull }; i < 1'000ull; ++i)
+			input.append(i % 7ull == 0ull ? "\xC3\xA9" : "abcdefghijklmnopqrstuvwxyz012345").append(i % 31ull, 'x');
+		std::vector<char32_t> decoded(input.size()), expected;
+		for (size_t i{ 0ull }; i < input.size(); ++i) {
+			const unsigned char ch{ static_cast<unsigned char>(input[i]) };
+			expected.emplace_back(ch < 0x80 ? ch : ((ch & 0x1Fu) << 6) | (static_cast<unsigned char>(input[++i]) & 0x3Fu));
+		}
+		const auto& result{ ascii::utf8::decode(reinterpret_cast<const unsigned char*>(input.data()), input.size(), decoded.data()) };
+		check(!result.error && result.read == input.size() && result.written == expected.size(), "ASCII decode", result.read, result.written);
+		decoded.resize(std::min(result.written, decoded.size()));
+		check(decoded == expected, "ASCII decode");
+	}
+
+	// TEMPERATURE
+	/// @brief	Checks the integral conversions between every pair of temperature systems against rounding the long double result.
+	void check_temperature()
+	{
+		std::mt19937_64 rng{ 307u };
+		std::vector<long long> values(2'000'001ull);
+		for (size_t i{ 0ull }; i < values.size(); ++i)
+			values[i] = static_cast<long long>(i) - 1'000'000ll;
+		for (long long const v : { 10'000'000'000'000ll, -10'000'000'000'000ll, 1'000'000'000'000'000ll, -1'000'000'000'000'000ll })
+			values.emplace_back(v);
+		std::uniform_int_distribution<long long> large{ -1'000'000'000'000'000ll, 1'000'000'000'000'000ll };
+		for (size_t i{ 0ull }; i < 100'000ull; ++i)
+			values.emplace_back(large(rng));
+
+		std::vector<long long> results(values.size());
+		for (size_t in{ 0ull }; in < 3ull; ++in) {
+			for (size_t out{ 0ull }; out < 3ull; ++out) {
+				const auto inputSystem{ static_cast<conv::TemperatureSystem>(in + 1) }, outputSystem{ static_cast<conv::TemperatureSystem>(out + 1) };
+				conv::convert(inputSystem, values.data(), results.data(), values.size(), outputSystem);
+				size_t mismatches{ 0ull };
+				for (size_t i{ 0ull }; i < values.size(); ++i) {
+					const long long expected{ std::llround(conv::TRANSFORMS[in][out](static_cast<long double>(values[i]))) };
+					if ((results[i] != expected || conv::convert(inputSystem, values[i], outputSystem) != expected) && mismatches++ == 0ull)
+						check(false, "temperature integral conversion", std::to_string(values[i]).append(" => ").append(std::to_string(results[i])));
+				}
+				check(mismatches == 0ull, "temperature integral conversions", in, out);
+			}
+		}
+	}
+
+#if defined(__SIZEOF_INT128__)
+	// RATIONAL
+	/// @brief	Returns value * factor formatted by conv::format, or the name of the error it returned.
+	std::string format(std::string_view const value, conv::rational const& factor, conv::FloatFormat const& fmt, size_t const bufferSize = 128ull)
+	{
+		conv::decimal input;
+		if (const auto& [ptr, ec] { conv::parse_decimal(value.data(), value.data() + value.size(), input) }; ec != std::errc{} || ptr != value.data() + value.size())
+			return "invalid";
+		std::string buf(bufferSize, '\0');
+		const auto& [end, ec] { conv::format(buf.data(), buf.data() + buf.size(), input, factor, fmt) };
+		if (ec == std::errc::result_out_of_range)
+			return "out of range";
+		if (ec == std::errc::value_too_large)
+			return "too large";
+		return buf.substr(0ull, static_cast<size_t>(end - buf.data()));
+	}
+
+	void check_rational()
+	{
+		using Notation = conv::FloatFormat::Notation;
+		const auto& one{ conv::rational::of(1, 1) };
+		const auto& fixed{ [](int const precision) { return conv::FloatFormat{ Notation::Fixed, precision }; } };
+		const auto& general{ [](int const precision) { return conv::FloatFormat{ Notation::General, precision }; } };
+		const conv::FloatFormat shortest{ Notation::General, 6, true };
+
+		struct Case {
+			std::string_view value;
+			conv::rational factor;
+			conv::FloatFormat fmt;
+			std::string_view expected;
+		};
+		const Case CASES[]{
+			// exact results
+			{ "1", conv::rational::of(1609344, 1000000), shortest, "1.609344" },
+			{ "-12.375", conv::rational::of(4, 1), general(6), "-49.5" },
+			{ "1,760", conv::rational::of(3, 1), general(6), "5280" },
+			// ties round to even
+			{ "0.125", one, fixed(2), "0.12" },
+			{ "0.135", one, fixed(2), "0.14" },
+			{ "0.145", one, fixed(2), "0.14" },
+			{ "2.5", one, fixed(0), "2" },
+			{ "3.5", one, fixed(0), "4" },
+			{ "0.1250000000000000000000000000000000001", one, fixed(2), "0.13" },
+			// rounding carries through every 9, into the integer part
+			{ "9.9996", one, fixed(3), "10.000" },
+			{ "0.9995", one, fixed(3), "1.000" },
+			{ "99.99", one, general(3), "100" },
+			{ "999.96", one, fixed(1), "1000.0" },
+			// significant digits start at the first non-zero digit
+			{ "0.000123456", one, general(3), "0.000123" },
+			{ "1", conv::rational::of(1, 3), general(6), "0.333333" },
+			{ "2", conv::rational::of(1, 3), shortest, "0.6666666666666666666666666666666666666667" },
+			// errors
+			{ "1", conv::rational::of(1, conv::uint128{ 1 } << 125), general(6), "out of range" },
+			{ "1", conv::rational{ 0, 0 }, general(6), "out of range" },
+		};
+		for (const auto& c : CASES) {
+			const auto& result{ format(c.value, c.factor, c.fmt) };
+			check(result == c.expected, "rational format", std::string{ c.value }.append(" => ").append(result));
+		}
+		check(format("1", one, general(6), 64ull) == "too large", "rational format buffer size");
+	}
+#endif
+}
+
+int main()
+{
+	check_bigint();
+	check_divisor();
+	check_format();
+	check_range();
+	check_fov();
+	check_ascii();
+	check_temperature();
+#if defined(__SIZEOF_INT128__)
+	check_rational();
+#endif
+	if (failures == 0)
+		std::printf("All checks passed.\n");
+	return failures == 0 ? 0 : 1;
+}
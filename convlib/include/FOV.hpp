@@ -5,7 +5,9 @@
  */
 #pragma once
 #include "radians.hpp"
+#include "simd.hpp"
 
+#include <cmath>
 #include <utility>
 
 namespace FOV {
@@ -77,4 +79,157 @@ namespace FOV {
 	{
 		return 2 * std::atan(std::tan(vertical / 2) * aspect.horizontalOverVertical());
 	}
-}
\ No newline at end of file
+
+#	if defined(CONVLIB_DISPATCH_AVX2)
+	namespace detail {
+		/// @brief	Returns a * b + c.
+		CONVLIB_TARGET_AVX2 inline __m256d madd(__m256d const a, __m256d const b, __m256d const c) noexcept
+		{
+		#if defined(__FMA__)
+			return _mm256_fmadd_pd(a, b, c);
+		#else
+			return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+		#endif
+		}
+
+		/**
+		 * @brief		Computes the tangent of 4 doubles at once, accurate to within a couple of ULPs.
+		 *\n			This uses the same range reduction & rational approximation as the Cephes math library, which is only
+		 *\n			 accurate while |x| <= TAN_LIMIT; larger & non-finite values must be handled by std::tan instead.
+		 */
+		CONVLIB_TARGET_AVX2 inline __m256d tan(__m256d x) noexcept
+		{
+			constexpr double DP1{ 7.853981554508209228515625E-1 }, DP2{ 7.94662735614792836714E-9 }, DP3{ 3.06161699786838294307E-17 };
+
+			const __m256d signMask{ _mm256_set1_pd(-0.0) }, one{ _mm256_set1_pd(1.0) };
+			const __m256d sign{ _mm256_and_pd(x, signMask) };
+			x = _mm256_andnot_pd(signMask, x);
+
+			// reduce the argument to [-pi/4, pi/4] by subtracting the nearest even multiple of pi/4 in extended precision
+			__m256d y{ _mm256_floor_pd(_mm256_mul_pd(x, _mm256_set1_pd(M_2_PI * 2.0))) };
+			const __m256d odd{ _mm256_cmp_pd(_mm256_sub_pd(y, _mm256_mul_pd(_mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.5))), _mm256_set1_pd(2.0))), one, _CMP_EQ_OQ) };
+			y = _mm256_add_pd(y, _mm256_and_pd(odd, one));
+			// odd multiples of pi/2 flip the tangent to -1 / tan
+			const __m256d flip{ _mm256_cmp_pd(_mm256_sub_pd(y, _mm256_mul_pd(_mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.25))), _mm256_set1_pd(4.0))), _mm256_set1_pd(2.0), _CMP_EQ_OQ) };
+			x = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(y, _mm256_set1_pd(DP1))), _mm256_mul_pd(y, _mm256_set1_pd(DP2))), _mm256_mul_pd(y, _mm256_set1_pd(DP3)));
+
+			const __m256d z{ _mm256_mul_pd(x, x) };
+			__m256d p{ madd(_mm256_set1_pd(-1.30936939181383777646E4), z, _mm256_set1_pd(1.15351664838587416140E6)) };
+			p = madd(p, z, _mm256_set1_pd(-1.79565251976484877988E7));
+			__m256d q{ _mm256_add_pd(z, _mm256_set1_pd(1.36812963470692954678E4)) };
+			q = madd(q, z, _mm256_set1_pd(-1.32089234440210967447E6));
+			q = madd(q, z, _mm256_set1_pd(2.50083801823357915839E7));
+			q = madd(q, z, _mm256_set1_pd(-5.38695755929454629881E7));
+			y = madd(x, _mm256_div_pd(_mm256_mul_pd(z, p), q), x);
+			y = _mm256_blendv_pd(y, _mm256_div_pd(_mm256_set1_pd(-1.0), y), flip);
+			return _mm256_xor_pd(y, sign);
+		}
+		// @brief	The largest magnitude that detail::tan accepts; below it, the multiples of pi/4 subtracted by the range reduction
+		//			 have at most 28 bits, so their products with DP1 & DP2 are exact.
+		inline constexpr double TAN_LIMIT{ 2e8 };
+
+		/**
+		 * @brief		Computes the arc tangent of 4 doubles at once, accurate to within a couple of ULPs.
+		 *\n			This uses the same range reduction & rational approximation as the Cephes math library.
+		 */
+		CONVLIB_TARGET_AVX2 inline __m256d atan(__m256d x) noexcept
+		{
+			constexpr double T3P8{ 2.41421356237309504880 }, MOREBITS{ 6.123233995736765886130E-17 };
+
+			const __m256d signMask{ _mm256_set1_pd(-0.0) }, one{ _mm256_set1_pd(1.0) };
+			const __m256d sign{ _mm256_and_pd(x, signMask) };
+			x = _mm256_andnot_pd(signMask, x);
+
+			// reduce the argument to [0, 0.66]
+			const __m256d big{ _mm256_cmp_pd(x, _mm256_set1_pd(T3P8), _CMP_GT_OQ) };
+			const __m256d mid{ _mm256_andnot_pd(big, _mm256_cmp_pd(x, _mm256_set1_pd(0.66), _CMP_GT_OQ)) };
+			__m256d y{ _mm256_or_pd(_mm256_and_pd(big, _mm256_set1_pd(M_PI_2)), _mm256_and_pd(mid, _mm256_set1_pd(M_PI_4))) };
+			const __m256d more{ _mm256_or_pd(_mm256_and_pd(big, _mm256_set1_pd(MOREBITS)), _mm256_and_pd(mid, _mm256_set1_pd(0.5 * MOREBITS))) };
+			x = _mm256_blendv_pd(x, _mm256_div_pd(_mm256_sub_pd(x, one), _mm256_add_pd(x, one)), mid);
+			x = _mm256_blendv_pd(x, _mm256_div_pd(_mm256_set1_pd(-1.0), x), big);
+
+			const __m256d z{ _mm256_mul_pd(x, x) };
+			__m256d p{ madd(_mm256_set1_pd(-8.750608600031904122785E-1), z, _mm256_set1_pd(-1.615753718733365076637E1)) };
+			p = madd(p, z, _mm256_set1_pd(-7.500855792314704667340E1));
+			p = madd(p, z, _mm256_set1_pd(-1.228866684490136173410E2));
+			p = madd(p, z, _mm256_set1_pd(-6.485021904942025371773E1));
+			__m256d q{ _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962E1)) };
+			q = madd(q, z, _mm256_set1_pd(1.650270098316988542046E2));
+			q = madd(q, z, _mm256_set1_pd(4.328810604912902668951E2));
+			q = madd(q, z, _mm256_set1_pd(4.853903996359136964868E2));
+			q = madd(q, z, _mm256_set1_pd(1.945506571482613964425E2));
+
+			const __m256d r{ madd(x, _mm256_div_pd(_mm256_mul_pd(z, p), q), x) };
+			y = _mm256_add_pd(y, _mm256_add_pd(r, more));
+			return _mm256_xor_pd(y, sign);
+		}
+
+		/// @brief	half_tangents for blocks of 4 values, with AVX2. The CPU must support it. Returns the number of values processed.
+		CONVLIB_TARGET_AVX2 inline size_t half_tangents_avx2(const double* in, double* out, size_t const count, double const scale) noexcept
+		{
+			const __m256d vScale{ _mm256_set1_pd(scale) }, vLimit{ _mm256_set1_pd(TAN_LIMIT) }, signMask{ _mm256_set1_pd(-0.0) };
+			size_t i{ 0ull };
+			for (; i + 4ull <= count; i += 4ull) {
+				const __m256d x{ _mm256_mul_pd(_mm256_loadu_pd(in + i), vScale) };
+				// blocks with huge or non-finite values are left to std::tan
+				if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(signMask, x), vLimit, _CMP_NLE_UQ)) != 0) {
+					for (size_t k{ i }; k < i + 4ull; ++k)
+						out[k] = std::tan(in[k] * scale);
+					continue;
+				}
+				_mm256_storeu_pd(out + i, tan(x));
+			}
+			return i;
+		}
+		/// @brief	convert_tangents for blocks of 4 values, with AVX2. The CPU must support it. Returns the number of values processed.
+		CONVLIB_TARGET_AVX2 inline size_t convert_tangents_avx2(const double* tangents, double* out, size_t const count, double const factor, double const scale) noexcept
+		{
+			const __m256d vFactor{ _mm256_set1_pd(factor) }, vScale{ _mm256_set1_pd(scale) };
+			size_t i{ 0ull };
+			for (; i + 4ull <= count; i += 4ull)
+				_mm256_storeu_pd(out + i, _mm256_mul_pd(atan(_mm256_mul_pd(_mm256_loadu_pd(tangents + i), vFactor)), vScale));
+			return i;
+		}
+	}
+#	endif
+
+	/**
+	 * @brief			Computes tan(x / 2) for a block of FOV values; the first step of converting them to another orientation.
+	 * @param in		Input FOV values.
+	 * @param out		Output tangents. This may be the same as in.
+	 * @param count		The number of values.
+	 * @param radians	When true, input values are in radians; otherwise they are in degrees.
+	 */
+	inline void half_tangents(const double* in, double* out, size_t const count, bool const radians)
+	{
+		const double scale{ radians ? 0.5 : M_PI / 360.0 };
+		size_t i{ 0ull };
+	#if defined(CONVLIB_DISPATCH_AVX2)
+		if (conv::has_avx2())
+			i = detail::half_tangents_avx2(in, out, count, scale);
+	#endif
+		for (; i < count; ++i)
+			out[i] = std::tan(in[i] * scale);
+	}
+
+	/**
+	 * @brief			Computes 2 * atan(tangent * factor) for a block of tangents produced by half_tangents.
+	 *\n				The tangents only depend on the input values, so they can be reused for any number of aspect ratios.
+	 * @param tangents	Input tangents.
+	 * @param out		Output FOV values.
+	 * @param count		The number of values.
+	 * @param factor	The aspect ratio factor; either verticalOverHorizontal() or horizontalOverVertical().
+	 * @param radians	When true, output values are in radians; otherwise they are in degrees.
+	 */
+	inline void convert_tangents(const double* tangents, double* out, size_t const count, double const factor, bool const radians)
+	{
+		const double scale{ radians ? 2.0 : 360.0 / M_PI };
+		size_t i{ 0ull };
+	#if defined(CONVLIB_DISPATCH_AVX2)
+		if (conv::has_avx2())
+			i = detail::convert_tangents_avx2(tangents, out, count, factor, scale);
+	#endif
+		for (; i < count; ++i)
+			out[i] = std::atan(tangents[i] * factor) * scale;
+	}
+}
@@ -0,0 +1,73 @@
+/**
+ * @file	affine.hpp
+ * @author	radj307
+ * @brief	Affine transforms (scale * x + offset) & a block kernel for applying them; every linear unit conversion is one of these.
+ */
+#pragma once
+#include <concepts>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace conv {
+	/**
+	 * @struct	affine
+	 * @brief	An affine transform (scale * x + offset).
+	 */
+	struct affine {
+		long double scale, offset;
+
+		/// @brief	Returns the transform that applies this one, followed by the given one.
+		constexpr affine then(affine const& next) const noexcept
+		{
+			return{ next.scale * scale, next.scale * offset + next.offset };
+		}
+
+		template<std::floating_point T>
+		constexpr T operator()(T const value) const noexcept
+		{
+			return static_cast<T>(scale) * value + static_cast<T>(offset);
+		}
+	};
+
+	/**
+	 * @brief				Applies an affine transform to a block of values.
+	 *\n					Uses AVX for float & double values when it is available.
+	 * @param t				The transform to apply.
+	 * @param in			Input values.
+	 * @param out			Output values. This may be the same as in.
+	 * @param count			The number of values.
+	 */
+	template<std::floating_point T>
+	inline void transform(affine const& t, T const* in, T* out, size_t const count) noexcept
+	{
+		size_t i{ 0ull };
+	#if defined(__AVX__)
+		if constexpr (std::same_as<T, double>) {
+			const __m256d scale{ _mm256_set1_pd(static_cast<double>(t.scale)) }, offset{ _mm256_set1_pd(static_cast<double>(t.offset)) };
+			for (; i + 4ull <= count; i += 4ull) {
+			#if defined(__FMA__)
+				_mm256_storeu_pd(out + i, _mm256_fmadd_pd(_mm256_loadu_pd(in + i), scale, offset));
+			#else
+				_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(in + i), scale), offset));
+			#endif
+			}
+		}
+		else if constexpr (std::same_as<T, float>) {
+			const __m256 scale{ _mm256_set1_ps(static_cast<float>(t.scale)) }, offset{ _mm256_set1_ps(static_cast<float>(t.offset)) };
+			for (; i + 8ull <= count; i += 8ull) {
+			#if defined(__FMA__)
+				_mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_loadu_ps(in + i), scale, offset));
+			#else
+				_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + i), scale), offset));
+			#endif
+			}
+		}
+	#endif
+		const T scale{ static_cast<T>(t.scale) }, offset{ static_cast<T>(t.offset) };
+		for (; i < count; ++i)
+			out[i] = scale * in[i] + offset;
+	}
+}
@@ -1,8 +1,22 @@
 #pragma once
+#include "simd.hpp"
+
 #include <sysarch.h>
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 namespace ascii {
 	using CharT = wchar_t;
 	using StrT = std::wstring;
@@ -36,4 +50,351 @@ namespace ascii {
 		s.shrink_to_fit();
 		return s;
 	}
+
+	/**
+	 * @enum	ByteFormat
+	 * @brief	Determines how byte values are rendered by ByteTable.
+	 */
+	enum class ByteFormat : unsigned char {
+		// [0 - 255]
+		Unsigned,
+		// [-128 - 127]
+		Signed,
+		// [00 - ff]
+		Hex,
+	};
+
+	/**
+	 * @struct	ByteTable
+	 * @brief	Precomputed text renderings of all 256 byte values, for dumping large amounts of binary data.
+	 *\n		Every entry is ENTRY_SIZE bytes long so it can be copied with a single fixed-size memcpy;
+	 *\n		 the output pointer is then advanced by the actual length of the rendering.
+	 */
+	struct ByteTable {
+		static constexpr size_t ENTRY_SIZE{ 8ull };
+		using Entry = std::array<char, ENTRY_SIZE>;
+
+		// @brief	Renderings preceded by a space & right-aligned to the width of the widest value.
+		std::array<Entry, 256> padded{};
+		// @brief	Renderings followed by a newline.
+		std::array<Entry, 256> bare{};
+		// @brief	The length of each bare entry, including the newline.
+		std::array<unsigned char, 256> bareLength{};
+		// @brief	The length of every padded entry.
+		size_t stride;
+
+		constexpr ByteTable(ByteFormat const format) : stride{ 1ull + (format == ByteFormat::Hex ? 2ull : (format == ByteFormat::Signed ? 4ull : 3ull)) }
+		{
+			constexpr char DIGITS[]{ "0123456789abcdef" };
+			for (int b{ 0 }; b < 256; ++b) {
+				char text[ENTRY_SIZE]{};
+				size_t len{ 0ull };
+				if (format == ByteFormat::Hex) {
+					text[len++] = DIGITS[b >> 4];
+					text[len++] = DIGITS[b & 0xF];
+				}
+				else {
+					int v{ (format == ByteFormat::Signed && b > 127) ? b - 256 : b };
+					if (v < 0) {
+						text[len++] = '-';
+						v = -v;
+					}
+					if (v >= 100) text[len++] = DIGITS[v / 100];
+					if (v >= 10) text[len++] = DIGITS[v / 10 % 10];
+					text[len++] = DIGITS[v % 10];
+				}
+
+				for (size_t i{ 0ull }; i < ENTRY_SIZE; ++i)
+					padded[b][i] = ' ';
+				for (size_t i{ 0ull }; i < len; ++i) {
+					padded[b][stride - len + i] = text[i];
+					bare[b][i] = text[i];
+				}
+				bare[b][len] = '\n';
+				bareLength[b] = static_cast<unsigned char>(len + 1ull);
+			}
+		}
+
+		/**
+		 * @brief			Returns the maximum number of characters that format_table or format_linear can write for the given number of bytes.
+		 * @param count		The number of input bytes.
+		 */
+		static constexpr size_t max_output_size(size_t const count) noexcept
+		{
+			return count * (ENTRY_SIZE + 1ull) + ENTRY_SIZE;
+		}
+
+		/**
+		 * @brief			Renders bytes as rows of right-aligned columns, like `od -An`.
+		 * @param in		Input bytes.
+		 * @param count		The number of input bytes.
+		 * @param out		Output buffer, which must be at least max_output_size(count) characters long.
+		 * @param column	The current column in the row. This is updated so that rows continue correctly across calls.
+		 * @param columns	The number of values in each row.
+		 * @returns			The number of characters written to out.
+		 */
+		size_t format_table(const unsigned char* in, size_t count, char* out, size_t& column, size_t const columns = 16ull) const noexcept
+		{
+			char* const begin{ out };
+			while (count != 0ull) {
+				const size_t n{ std::min(count, columns - column) };
+				for (size_t i{ 0ull }; i < n; ++i, out += stride)
+					std::memcpy(out, padded[in[i]].data(), ENTRY_SIZE);
+				in += n;
+				count -= n;
+				if ((column += n) == columns) {
+					*out++ = '\n';
+					column = 0ull;
+				}
+			}
+			return static_cast<size_t>(out - begin);
+		}
+
+		/**
+		 * @brief			Renders bytes with one value per line.
+		 * @param in		Input bytes.
+		 * @param count		The number of input bytes.
+		 * @param out		Output buffer, which must be at least max_output_size(count) characters long.
+		 * @returns			The number of characters written to out.
+		 */
+		size_t format_linear(const unsigned char* in, size_t const count, char* out) const noexcept
+		{
+			char* const begin{ out };
+			for (size_t i{ 0ull }; i < count; ++i) {
+				std::memcpy(out, bare[in[i]].data(), ENTRY_SIZE);
+				out += bareLength[in[i]];
+			}
+			return static_cast<size_t>(out - begin);
+		}
+	};
+
+	/// @brief	Precomputed tables for each ByteFormat.
+	inline constexpr ByteTable BYTE_TABLES[]{ ByteTable{ ByteFormat::Unsigned }, ByteTable{ ByteFormat::Signed }, ByteTable{ ByteFormat::Hex } };
+
+	namespace utf8 {
+		/// @brief	Returns the length of the UTF-8 sequence that begins with the given lead byte, or 0 if it cannot begin a sequence.
+		inline constexpr size_t sequence_length(unsigned char const lead) noexcept
+		{
+			if (lead < 0x80) return 1ull;
+			if (lead < 0xC2) return 0ull; // continuation bytes & overlong 2-byte leads
+			if (lead < 0xE0) return 2ull;
+			if (lead < 0xF0) return 3ull;
+			if (lead < 0xF5) return 4ull;
+			return 0ull;
+		}
+
+	#if defined(CONVLIB_DISPATCH_AVX2)
+		/// @brief	widen_ascii for blocks of 32 bytes, with AVX2. The CPU must support it.
+		CONVLIB_TARGET_AVX2 inline size_t widen_ascii_avx2(const unsigned char* in, size_t const n, char32_t* out) noexcept
+		{
+			size_t i{ 0ull };
+			for (; i + 32ull <= n; i += 32ull) {
+				const __m256i v{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)) };
+				if (_mm256_movemask_epi8(v) != 0)
+					break;
+				for (size_t k{ 0ull }; k < 32ull; k += 8ull)
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + k), _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i + k))));
+			}
+			return i;
+		}
+	#endif
+
+		/**
+		 * @brief		Widens the ASCII bytes at the beginning of the input to code points, in blocks of 16 or 32 bytes with SIMD
+		 *\n			 instructions when they are available. Uses AVX2 when the CPU supports it.
+		 * @param in	Input bytes.
+		 * @param n		The number of input bytes.
+		 * @param out	Output buffer, which must have room for at least n code points.
+		 * @returns		The number of bytes widened; the rest must be decoded one at a time.
+		 */
+		inline size_t widen_ascii(const unsigned char* in, size_t const n, char32_t* out) noexcept
+		{
+		#if defined(CONVLIB_DISPATCH_AVX2)
+			if (conv::has_avx2())
+				return widen_ascii_avx2(in, n, out);
+		#endif
+			size_t i{ 0ull };
+		#if defined(__SSE2__) || defined(_M_X64)
+			for (; i + 16ull <= n; i += 16ull) {
+				const __m128i v{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)) };
+				if (_mm_movemask_epi8(v) != 0)
+					break;
+				const __m128i zero{ _mm_setzero_si128() }, lo{ _mm_unpacklo_epi8(v, zero) }, hi{ _mm_unpackhi_epi8(v, zero) };
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4ull), _mm_unpackhi_epi16(lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8ull), _mm_unpacklo_epi16(hi, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12ull), _mm_unpackhi_epi16(hi, zero));
+			}
+		#else
+			(void)in, (void)n, (void)out;
+		#endif
+			return i;
+		}
+
+		/**
+		 * @struct	DecodeResult
+		 * @brief	The result of a call to decode.
+		 */
+		struct DecodeResult {
+			// @brief	The number of input bytes consumed. When error is true, this is the offset of the invalid sequence.
+			size_t read;
+			// @brief	The number of code points written to the output.
+			size_t written;
+			// @brief	True when an invalid sequence was encountered.
+			bool error;
+		};
+
+		/**
+		 * @brief		Decodes & validates UTF-8 input into Unicode scalar values.
+		 *\n			Runs of ASCII are widened with SIMD instructions when they are available.
+		 *\n			Decoding stops early at an invalid sequence, or at a sequence that is cut off by the end of the input;
+		 *\n			 in the latter case the remaining bytes should be passed again along with the rest of the input.
+		 * @param in	Input bytes.
+		 * @param n		The number of input bytes.
+		 * @param out	Output buffer, which must have room for at least n code points.
+		 * @returns		DecodeResult
+		 */
+		inline DecodeResult decode(const unsigned char* in, size_t const n, char32_t* out) noexcept
+		{
+			constexpr char32_t MIN_VALUE[5]{ 0, 0, 0x80, 0x800, 0x10000 };
+			size_t i{ 0ull }, o{ 0ull };
+
+			while (i < n) {
+				// ASCII fast path
+				const size_t ascii{ widen_ascii(in + i, n - i, out + o) };
+				i += ascii;
+				o += ascii;
+				if (i == n)
+					break;
+
+				const unsigned char lead{ in[i] };
+				if (lead < 0x80) {
+					out[o++] = lead;
+					++i;
+					continue;
+				}
+
+				const size_t len{ sequence_length(lead) };
+				if (len == 0ull)
+					return{ i, o, true };
+				if (i + len > n) // cut off by the end of the input
+					return{ i, o, false };
+
+				char32_t cp{ static_cast<char32_t>(lead & (0x7F >> len)) };
+				for (size_t k{ 1ull }; k < len; ++k) {
+					if ((in[i + k] & 0xC0) != 0x80)
+						return{ i, o, true };
+					cp = (cp << 6) | (in[i + k] & 0x3F);
+				}
+				if (cp < MIN_VALUE[len] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) // overlong, surrogate, or out of range
+					return{ i, o, true };
+
+				out[o++] = cp;
+				i += len;
+			}
+			return{ i, o, false };
+		}
+
+		/**
+		 * @brief		Encodes a Unicode scalar value as UTF-8.
+		 * @param cp	The code point to encode.
+		 * @param out	Output buffer, which must have room for at least 4 bytes.
+		 * @returns		The number of bytes written, or 0 if cp is not a valid Unicode scalar value.
+		 */
+		inline constexpr size_t encode(char32_t const cp, char* out) noexcept
+		{
+			if (cp < 0x80) {
+				out[0] = static_cast<char>(cp);
+				return 1ull;
+			}
+			if (cp < 0x800) {
+				out[0] = static_cast<char>(0xC0 | (cp >> 6));
+				out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+				return 2ull;
+			}
+			if (cp < 0x10000) {
+				if (cp >= 0xD800 && cp <= 0xDFFF)
+					return 0ull;
+				out[0] = static_cast<char>(0xE0 | (cp >> 12));
+				out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+				out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+				return 3ull;
+			}
+			if (cp <= 0x10FFFF) {
+				out[0] = static_cast<char>(0xF0 | (cp >> 18));
+				out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+				out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+				out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+				return 4ull;
+			}
+			return 0ull;
+		}
+	}
+
+	/**
+	 * @brief		Decodes a UTF-8 string into its Unicode code point values.
+	 * @param s		UTF-8 encoded input string.
+	 * @returns		ValueCont
+	 */
+	inline ValueCont to_ascii(std::string_view const s)
+	{
+		std::vector<char32_t> buf(s.size());
+		const auto& result{ utf8::decode(reinterpret_cast<const unsigned char*>(s.data()), s.size(), buf.data()) };
+		if (result.error || result.read != s.size())
+			throw make_exception("Invalid UTF-8 sequence at byte ", result.read, " of \"", s, "\"!");
+		return ValueCont(buf.begin(), buf.begin() + result.written);
+	}
+	/**
+	 * @brief		Encodes Unicode code point values as a UTF-8 string.
+	 * @param vc	Input code points.
+	 * @returns		std::string
+	 */
+	inline std::string to_utf8(ValueCont const& vc)
+	{
+		std::string s;
+		s.reserve(vc.size());
+		char buf[4];
+		for (const auto& v : vc) {
+			const size_t len{ v < 0 ? 0ull : utf8::encode(static_cast<char32_t>(v), buf) };
+			if (len == 0ull)
+				throw make_exception("'", v, "' is not a valid Unicode code point!");
+			s.append(buf, len);
+		}
+		return s;
+	}
+
+	/**
+	 * @brief			Renders code points as decimal or hexadecimal numbers.
+	 * @param in		Input code points.
+	 * @param count		The number of input code points.
+	 * @param out		Output buffer, which must have room for at least (count * 9 + 1) characters.
+	 * @param hex		When true, code points are rendered in hexadecimal.
+	 * @param column	The current column in the row. This is updated so that rows continue correctly across calls.
+	 * @param columns	The number of values in each row, or 0 to print one value per line.
+	 * @returns			The number of characters written to out.
+	 */
+	inline size_t format_code_points(const char32_t* in, size_t const count, char* out, bool const hex, size_t& column, size_t const columns)
+	{
+		const size_t width{ hex ? 6ull : 7ull }; // the widest values are 10ffff & 1114111
+		char* const begin{ out };
+		for (size_t i{ 0ull }; i < count; ++i) {
+			char text[8];
+			const size_t len{ static_cast<size_t>(std::to_chars(text, text + sizeof(text), static_cast<std::uint32_t>(in[i]), hex ? 16 : 10).ptr - text) };
+			if (columns == 0ull) {
+				std::memcpy(out, text, len);
+				out += len;
+				*out++ = '\n';
+				continue;
+			}
+			std::memset(out, ' ', 1ull + width - len);
+			out += 1ull + width - len;
+			std::memcpy(out, text, len);
+			out += len;
+			if (++column == columns) {
+				*out++ = '\n';
+				column = 0ull;
+			}
+		}
+		return static_cast<size_t>(out - begin);
+	}
 }
@@ -21,11 +21,11 @@ namespace base {
 			DECIMAL = 10,
 			HEXADECIMAL = 16,
 		};
-		[[nodiscard]] Base operator|(const Base& l, const Base& r) { return static_cast<Base>(static_cast<BaseT>(l) | static_cast<BaseT>(r)); }
-		[[nodiscard]] Base operator^(const Base& l, const Base& r) { return static_cast<Base>(static_cast<BaseT>(l) ^ static_cast<BaseT>(r)); }
-		[[nodiscard]] Base operator&(const Base& l, const Base& r) { return static_cast<Base>(static_cast<BaseT>(l) & static_cast<BaseT>(r)); }
-		[[nodiscard]] bool operator==(Base& base, const BaseT& o) { return static_cast<BaseT>(base) == o; }
-		[[nodiscard]] bool operator==(BaseT& baset, const Base& o) { return baset == static_cast<BaseT>(o); }
+		[[nodiscard]] inline Base operator|(const Base& l, const Base& r) { return static_cast<Base>(static_cast<BaseT>(l) | static_cast<BaseT>(r)); }
+		[[nodiscard]] inline Base operator^(const Base& l, const Base& r) { return static_cast<Base>(static_cast<BaseT>(l) ^ static_cast<BaseT>(r)); }
+		[[nodiscard]] inline Base operator&(const Base& l, const Base& r) { return static_cast<Base>(static_cast<BaseT>(l) & static_cast<BaseT>(r)); }
+		[[nodiscard]] inline bool operator==(Base& base, const BaseT& o) { return static_cast<BaseT>(base) == o; }
+		[[nodiscard]] inline bool operator==(BaseT& baset, const Base& o) { return baset == static_cast<BaseT>(o); }
 		[[nodiscard]] bool operator!=(Base& base, auto&& o) { return !operator==(base, std::forward<decltype(o)>(o)); }
 
 		inline std::string BaseToString(const Base& b)
@@ -0,0 +1,668 @@
+/**
+ * @file	bigint.hpp
+ * @author	radj307
+ * @brief	Arbitrary-precision signed integer type used when results no longer fit in native integers.
+ */
+#pragma once
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bigint {
+	/// @brief	A single digit of a big integer's magnitude, in base 2^32.
+	using limb = std::uint32_t;
+	/// @brief	Double-width limb type used for intermediate products.
+	using dlimb = std::uint64_t;
+	/// @brief	Little-endian limb vector representing an unsigned magnitude. Never contains leading (most-significant) zero limbs.
+	using magnitude = std::vector<limb>;
+
+	/// @brief	Operands with fewer limbs than this are multiplied with the schoolbook algorithm instead of Karatsuba.
+	inline constexpr size_t KARATSUBA_THRESHOLD{ 32ull };
+
+	namespace detail {
+		inline void trim(magnitude& m) noexcept
+		{
+			while (!m.empty() && m.back() == 0)
+				m.pop_back();
+		}
+
+		inline int compare(limb const* a, size_t const an, limb const* b, size_t const bn) noexcept
+		{
+			if (an != bn)
+				return an < bn ? -1 : 1;
+			for (size_t i{ an }; i-- > 0;)
+				if (a[i] != b[i])
+					return a[i] < b[i] ? -1 : 1;
+			return 0;
+		}
+		inline int compare(magnitude const& a, magnitude const& b) noexcept
+		{
+			return compare(a.data(), a.size(), b.data(), b.size());
+		}
+
+		/// @brief	Adds b to a in-place, starting at the given limb offset of a.
+		inline void add_to(magnitude& a, limb const* b, size_t const bn, size_t const offset = 0ull)
+		{
+			if (a.size() < offset + bn)
+				a.resize(offset + bn, 0);
+			dlimb carry{ 0 };
+			size_t i{ 0ull };
+			for (; i < bn; ++i) {
+				carry += static_cast<dlimb>(a[offset + i]) + b[i];
+				a[offset + i] = static_cast<limb>(carry);
+				carry >>= 32;
+			}
+			for (size_t j{ offset + i }; carry != 0; ++j) {
+				if (j == a.size())
+					a.push_back(0);
+				carry += a[j];
+				a[j] = static_cast<limb>(carry);
+				carry >>= 32;
+			}
+		}
+		inline void add_to(magnitude& a, magnitude const& b, size_t const offset = 0ull)
+		{
+			add_to(a, b.data(), b.size(), offset);
+		}
+
+		/// @brief	Subtracts b from a in-place. The magnitude of a must be greater than or equal to b.
+		inline void sub_from(magnitude& a, limb const* b, size_t const bn)
+		{
+			std::int64_t borrow{ 0 };
+			size_t i{ 0ull };
+			for (; i < bn; ++i) {
+				borrow += static_cast<std::int64_t>(a[i]) - b[i];
+				a[i] = static_cast<limb>(borrow);
+				borrow >>= 32;
+			}
+			for (; borrow != 0 && i < a.size(); ++i) {
+				borrow += a[i];
+				a[i] = static_cast<limb>(borrow);
+				borrow >>= 32;
+			}
+			trim(a);
+		}
+		inline void sub_from(magnitude& a, magnitude const& b)
+		{
+			sub_from(a, b.data(), b.size());
+		}
+
+		inline magnitude mul_schoolbook(limb const* a, size_t const an, limb const* b, size_t const bn)
+		{
+			if (an == 0 || bn == 0)
+				return{};
+			magnitude out(an + bn, 0);
+			for (size_t i{ 0ull }; i < an; ++i) {
+				dlimb carry{ 0 };
+				const dlimb ai{ a[i] };
+				if (ai == 0)
+					continue;
+				for (size_t j{ 0ull }; j < bn; ++j) {
+					carry += ai * b[j] + out[i + j];
+					out[i + j] = static_cast<limb>(carry);
+					carry >>= 32;
+				}
+				out[i + bn] = static_cast<limb>(carry);
+			}
+			trim(out);
+			return out;
+		}
+
+		inline magnitude make_magnitude(limb const* p, size_t n)
+		{
+			while (n > 0 && p[n - 1] == 0)
+				--n;
+			return magnitude(p, p + n);
+		}
+
+		/**
+		 * @brief	Karatsuba multiplication. Splits both operands at half the length of the longer one, and
+		 *\n		recurses with three half-size products instead of four.
+		 */
+		inline magnitude mul(limb const* a, size_t an, limb const* b, size_t bn)
+		{
+			if (an < bn)
+				std::swap(a, b), std::swap(an, bn);
+			if (bn < KARATSUBA_THRESHOLD)
+				return mul_schoolbook(a, an, b, bn);
+
+			const size_t m{ an / 2ull };
+			if (bn <= m) { // unbalanced operands; split only the longer one
+				magnitude out{ mul(a, m, b, bn) };
+				const magnitude hi{ mul(a + m, an - m, b, bn) };
+				add_to(out, hi, m);
+				trim(out);
+				return out;
+			}
+
+			const magnitude a0{ make_magnitude(a, m) }, a1{ make_magnitude(a + m, an - m) };
+			const magnitude b0{ make_magnitude(b, m) }, b1{ make_magnitude(b + m, bn - m) };
+
+			const magnitude z0{ mul(a0.data(), a0.size(), b0.data(), b0.size()) };
+			const magnitude z2{ mul(a1.data(), a1.size(), b1.data(), b1.size()) };
+
+			magnitude sa{ a0 }, sb{ b0 };
+			add_to(sa, a1);
+			add_to(sb, b1);
+			magnitude z1{ mul(sa.data(), sa.size(), sb.data(), sb.size()) };
+			sub_from(z1, z0);
+			sub_from(z1, z2);
+
+			magnitude out{ z0 };
+			out.reserve(an + bn);
+			add_to(out, z1, m);
+			add_to(out, z2, 2ull * m);
+			trim(out);
+			return out;
+		}
+		inline magnitude mul(magnitude const& a, magnitude const& b)
+		{
+			return mul(a.data(), a.size(), b.data(), b.size());
+		}
+
+		/// @brief	Multiplies a in-place by a single limb, then adds another single limb.
+		inline void mul_add_small(magnitude& a, limb const mul, limb const add)
+		{
+			dlimb carry{ add };
+			for (auto& l : a) {
+				carry += static_cast<dlimb>(l) * mul;
+				l = static_cast<limb>(carry);
+				carry >>= 32;
+			}
+			if (carry != 0)
+				a.push_back(static_cast<limb>(carry));
+		}
+
+		/// @brief	Divides a in-place by a single limb, and returns the remainder.
+		inline limb div_small(magnitude& a, limb const div)
+		{
+			dlimb rem{ 0 };
+			for (size_t i{ a.size() }; i-- > 0;) {
+				rem = (rem << 32) | a[i];
+				a[i] = static_cast<limb>(rem / div);
+				rem %= div;
+			}
+			trim(a);
+			return static_cast<limb>(rem);
+		}
+
+		inline int clz(limb v) noexcept
+		{
+			int n{ 0 };
+			if (v == 0)
+				return 32;
+			while ((v & 0x80000000u) == 0)
+				v <<= 1, ++n;
+			return n;
+		}
+
+		/**
+		 * @brief		Long division of magnitudes (Knuth, TAOCP Vol. 2, 4.3.1, Algorithm D).
+		 * @param u		Dividend.
+		 * @param v		Divisor. Must not be zero.
+		 * @param q		Receives the quotient.
+		 * @param r		Receives the remainder.
+		 */
+		inline void divmod(magnitude const& u, magnitude const& v, magnitude& q, magnitude& r)
+		{
+			if (v.empty())
+				throw make_exception("Cannot divide by zero!");
+			if (compare(u, v) < 0) {
+				q.clear();
+				r = u;
+				return;
+			}
+			if (v.size() == 1ull) {
+				q = u;
+				const limb rem{ div_small(q, v[0]) };
+				r.clear();
+				if (rem != 0)
+					r.push_back(rem);
+				return;
+			}
+
+			const size_t n{ v.size() }, m{ u.size() - v.size() };
+			const int s{ clz(v.back()) };
+
+			// normalize so that the divisor's most significant bit is set
+			magnitude vn(n), un(u.size() + 1ull);
+			for (size_t i{ n - 1ull }; i > 0; --i)
+				vn[i] = (v[i] << s) | (s == 0 ? 0 : static_cast<limb>(static_cast<dlimb>(v[i - 1]) >> (32 - s)));
+			vn[0] = v[0] << s;
+			un[u.size()] = s == 0 ? 0 : static_cast<limb>(static_cast<dlimb>(u.back()) >> (32 - s));
+			for (size_t i{ u.size() - 1ull }; i > 0; --i)
+				un[i] = (u[i] << s) | (s == 0 ? 0 : static_cast<limb>(static_cast<dlimb>(u[i - 1]) >> (32 - s)));
+			un[0] = u[0] << s;
+
+			q.assign(m + 1ull, 0);
+			constexpr dlimb base{ 1ull << 32 };
+
+			for (size_t j{ m + 1ull }; j-- > 0;) {
+				const dlimb num{ (static_cast<dlimb>(un[j + n]) << 32) | un[j + n - 1] };
+				dlimb qhat{ num / vn[n - 1] }, rhat{ num % vn[n - 1] };
+				while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+					--qhat;
+					rhat += vn[n - 1];
+					if (rhat >= base)
+						break;
+				}
+
+				// multiply & subtract
+				std::int64_t borrow{ 0 };
+				dlimb carry{ 0 };
+				for (size_t i{ 0ull }; i < n; ++i) {
+					const dlimb p{ qhat * vn[i] + carry };
+					carry = p >> 32;
+					const std::int64_t t{ static_cast<std::int64_t>(un[i + j]) - static_cast<std::int64_t>(p & 0xFFFFFFFFull) + borrow };
+					un[i + j] = static_cast<limb>(t);
+					borrow = t >> 32;
+				}
+				const std::int64_t t{ static_cast<std::int64_t>(un[j + n]) - static_cast<std::int64_t>(carry) + borrow };
+				un[j + n] = static_cast<limb>(t);
+
+				if (t < 0) { // qhat was one too large; add back
+					--qhat;
+					dlimb c{ 0 };
+					for (size_t i{ 0ull }; i < n; ++i) {
+						c += static_cast<dlimb>(un[i + j]) + vn[i];
+						un[i + j] = static_cast<limb>(c);
+						c >>= 32;
+					}
+					un[j + n] = static_cast<limb>(static_cast<dlimb>(un[j + n]) + c);
+				}
+				q[j] = static_cast<limb>(qhat);
+			}
+			trim(q);
+
+			// unnormalize the remainder
+			r.assign(n, 0);
+			for (size_t i{ 0ull }; i < n; ++i)
+				r[i] = (un[i] >> s) | (s == 0 ? 0 : static_cast<limb>(static_cast<dlimb>(un[i + 1]) << (32 - s)));
+			trim(r);
+		}
+	}
+
+	/**
+	 * @class	integer
+	 * @brief	Arbitrary-precision signed integer, stored as a sign & a base-2^32 magnitude.
+	 */
+	class integer {
+		magnitude mag;
+		bool negative{ false };
+
+		integer(magnitude&& m, bool const neg) : mag{ std::move(m) }, negative{ neg && !mag.empty() } {}
+
+	public:
+		integer() = default;
+		template<std::integral T>
+		integer(T const v)
+		{
+			unsigned long long m{ static_cast<unsigned long long>(v) };
+			if constexpr (std::signed_integral<T>) {
+				if (v < 0) {
+					negative = true;
+					m = 0ull - m;
+				}
+			}
+			while (m != 0) {
+				mag.push_back(static_cast<limb>(m));
+				m >>= 32;
+			}
+		}
+
+		/**
+		 * @brief		Parse a string of digits in the given radix. A leading '-' is accepted; prefixes are not.
+		 * @param s		Input string.
+		 * @param radix	Numeric base of the input, in the range [2 - 36].
+		 * @returns		integer
+		 */
+		static integer parse(std::string_view s, unsigned const radix = 10u)
+		{
+			bool neg{ false };
+			if (!s.empty() && (s.front() == '-' || s.front() == '+'))
+				neg = s.front() == '-', s.remove_prefix(1);
+			if (s.empty())
+				throw make_exception("Invalid integer: no digits were specified!");
+
+			// group as many digits per step as will fit in a limb
+			limb chunk_max{ radix };
+			unsigned chunk_len{ 1u };
+			while (static_cast<dlimb>(chunk_max) * radix <= 0xFFFFFFFFull)
+				chunk_max *= radix, ++chunk_len;
+
+			magnitude m;
+			m.reserve(s.size() / chunk_len + 1ull);
+			limb acc{ 0 }, mul{ 1 };
+			unsigned n{ 0u };
+			for (const char c : s) {
+				unsigned d;
+				if (c >= '0' && c <= '9')
+					d = static_cast<unsigned>(c - '0');
+				else if (c >= 'a' && c <= 'z')
+					d = static_cast<unsigned>(c - 'a' + 10);
+				else if (c >= 'A' && c <= 'Z')
+					d = static_cast<unsigned>(c - 'A' + 10);
+				else if (c == '\'' || c == ',' || c == '_') // digit separators
+					continue;
+				else d = radix;
+				if (d >= radix)
+					throw make_exception("Invalid base-", radix, " digit '", c, "'");
+				acc = acc * radix + d;
+				mul *= radix;
+				if (++n == chunk_len) {
+					detail::mul_add_small(m, mul, acc);
+					acc = 0, mul = 1, n = 0u;
+				}
+			}
+			if (n != 0u)
+				detail::mul_add_small(m, mul, acc);
+			detail::trim(m);
+			return{ std::move(m), neg };
+		}
+
+		/// @brief	Creates a non-negative integer from a little-endian limb vector.
+		static integer from_limbs(magnitude m)
+		{
+			detail::trim(m);
+			return{ std::move(m), false };
+		}
+
+		bool is_zero() const noexcept { return mag.empty(); }
+		bool is_negative() const noexcept { return negative; }
+		bool is_odd() const noexcept { return !mag.empty() && (mag[0] & 1u) != 0; }
+		magnitude const& limbs() const noexcept { return mag; }
+
+		/// @brief	Returns the number of significant bits in the magnitude.
+		size_t bit_length() const noexcept
+		{
+			if (mag.empty())
+				return 0ull;
+			return mag.size() * 32ull - static_cast<size_t>(detail::clz(mag.back()));
+		}
+		/// @brief	Returns true if the value fits in a long long.
+		bool fits_ll() const noexcept
+		{
+			if (mag.size() > 2ull)
+				return false;
+			const auto m{ magnitude_ull() };
+			return negative ? m <= 0x8000000000000000ull : m <= 0x7FFFFFFFFFFFFFFFull;
+		}
+		/// @brief	Returns the lowest 64 bits of the magnitude.
+		unsigned long long magnitude_ull() const noexcept
+		{
+			unsigned long long v{ 0ull };
+			if (mag.size() > 0ull) v |= mag[0];
+			if (mag.size() > 1ull) v |= static_cast<unsigned long long>(mag[1]) << 32;
+			return v;
+		}
+		/// @brief	Converts to a long long. The value must satisfy fits_ll().
+		long long to_ll() const noexcept
+		{
+			const auto m{ magnitude_ull() };
+			return negative ? static_cast<long long>(0ull - m) : static_cast<long long>(m);
+		}
+		/// @brief	Converts to the nearest representable long double. Values that are too large become infinity.
+		long double to_long_double() const noexcept
+		{
+			long double v{ 0.0L };
+			for (size_t i{ mag.size() }; i-- > 0;)
+				v = v * 4294967296.0L + static_cast<long double>(mag[i]);
+			return negative ? -v : v;
+		}
+
+		/**
+		 * @brief		Returns the string representation of this value in the given radix.
+		 * @param radix	Numeric base of the output, in the range [2 - 36].
+		 * @returns		std::string
+		 */
+		std::string to_string(unsigned const radix = 10u) const
+		{
+			if (mag.empty())
+				return "0";
+			constexpr char digits[]{ "0123456789abcdefghijklmnopqrstuvwxyz" };
+
+			limb chunk_div{ radix };
+			unsigned chunk_len{ 1u };
+			while (static_cast<dlimb>(chunk_div) * radix <= 0xFFFFFFFFull)
+				chunk_div *= radix, ++chunk_len;
+
+			std::string s;
+			s.reserve(bit_length() / 3ull + 2ull);
+			magnitude m{ mag };
+			while (!m.empty()) {
+				limb rem{ detail::div_small(m, chunk_div) };
+				for (unsigned i{ 0u }; i < chunk_len && (rem != 0 || !m.empty()); ++i) {
+					s.push_back(digits[rem % radix]);
+					rem /= radix;
+				}
+			}
+			if (negative)
+				s.push_back('-');
+			std::reverse(s.begin(), s.end());
+			return s;
+		}
+
+		integer operator-() const { return{ magnitude{ mag }, !negative }; }
+		integer abs() const { return{ magnitude{ mag }, false }; }
+
+		friend integer operator+(integer const& l, integer const& r)
+		{
+			if (l.negative == r.negative) {
+				magnitude m{ l.mag };
+				detail::add_to(m, r.mag);
+				return{ std::move(m), l.negative };
+			}
+			// signs differ; subtract the smaller magnitude from the larger
+			if (detail::compare(l.mag, r.mag) >= 0) {
+				magnitude m{ l.mag };
+				detail::sub_from(m, r.mag);
+				return{ std::move(m), l.negative };
+			}
+			magnitude m{ r.mag };
+			detail::sub_from(m, l.mag);
+			return{ std::move(m), r.negative };
+		}
+		friend integer operator-(integer const& l, integer const& r) { return l + -r; }
+		friend integer operator*(integer const& l, integer const& r)
+		{
+			return{ detail::mul(l.mag, r.mag), l.negative != r.negative };
+		}
+		/// @brief	Truncating division, matching the semantics of the builtin integer types.
+		friend integer operator/(integer const& l, integer const& r)
+		{
+			magnitude q, rem;
+			detail::divmod(l.mag, r.mag, q, rem);
+			return{ std::move(q), l.negative != r.negative };
+		}
+		/// @brief	Truncating remainder; the result has the same sign as the dividend, matching the builtin integer types.
+		friend integer operator%(integer const& l, integer const& r)
+		{
+			magnitude q, rem;
+			detail::divmod(l.mag, r.mag, q, rem);
+			return{ std::move(rem), l.negative };
+		}
+		integer& operator+=(integer const& o) { return *this = *this + o; }
+		integer& operator-=(integer const& o) { return *this = *this - o; }
+		integer& operator*=(integer const& o) { return *this = *this * o; }
+		integer& operator/=(integer const& o) { return *this = *this / o; }
+		integer& operator%=(integer const& o) { return *this = *this % o; }
+
+		friend bool operator==(integer const& l, integer const& r) noexcept
+		{
+			return l.negative == r.negative && l.mag == r.mag;
+		}
+		friend std::strong_ordering operator<=>(integer const& l, integer const& r) noexcept
+		{
+			if (l.negative != r.negative)
+				return l.negative ? std::strong_ordering::less : std::strong_ordering::greater;
+			const int c{ detail::compare(l.mag, r.mag) };
+			if (c == 0)
+				return std::strong_ordering::equal;
+			return ((c < 0) != l.negative) ? std::strong_ordering::less : std::strong_ordering::greater;
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, integer const& v)
+		{
+			if ((os.flags() & std::ios_base::basefield) == std::ios_base::hex)
+				return os << (os.flags() & std::ios_base::showbase ? "0x" : "") << v.to_string(16u);
+			else if ((os.flags() & std::ios_base::basefield) == std::ios_base::oct)
+				return os << (os.flags() & std::ios_base::showbase ? "0" : "") << v.to_string(8u);
+			return os << v.to_string(10u);
+		}
+	};
+
+	/**
+	 * @brief		Raise a big integer to a power by repeated squaring.
+	 * @param base	The number to raise.
+	 * @param exp	The exponent.
+	 * @returns		integer
+	 */
+	inline integer pow(integer base, unsigned long long exp)
+	{
+		integer result{ 1 };
+		while (exp != 0) {
+			if ((exp & 1ull) != 0)
+				result *= base;
+			if ((exp >>= 1) != 0)
+				base *= base;
+		}
+		return result;
+	}
+
+	/**
+	 * @class	montgomery
+	 * @brief	Montgomery multiplication context for a fixed odd multi-limb modulus, with R = 2^(32 * limbs).
+	 *\n		Uses the coarsely integrated operand scanning (CIOS) method, which interleaves the
+	 *\n		multiplication & reduction steps one limb at a time.
+	 */
+	class montgomery {
+		magnitude n;
+		/// @brief	-n^-1 mod 2^32
+		limb n0inv;
+		/// @brief	R^2 mod n
+		magnitude r2;
+
+		/// @brief	Pads a magnitude with zeroes to the size of the modulus.
+		magnitude pad(magnitude m) const
+		{
+			m.resize(n.size(), 0);
+			return m;
+		}
+
+	public:
+		montgomery(integer const& odd_modulus) : n{ odd_modulus.limbs() }
+		{
+			if (!odd_modulus.is_odd())
+				throw make_exception("Montgomery multiplication requires an odd modulus!");
+			limb inv{ n[0] }; // Newton's iteration; correct to 3 bits initially
+			for (int i{ 0 }; i < 4; ++i)
+				inv *= 2u - n[0] * inv;
+			n0inv = 0u - inv;
+
+			magnitude r(2ull * n.size() + 1ull, 0), q;
+			r.back() = 1u;
+			detail::divmod(r, n, q, r2);
+			r2 = pad(std::move(r2));
+		}
+
+		/// @brief	Returns (a * b * R^-1) mod n. Both operands must be padded to the size of the modulus, & less than n.
+		magnitude mul(magnitude const& a, magnitude const& b) const
+		{
+			const size_t s{ n.size() };
+			magnitude t(s + 2ull, 0);
+			for (size_t i{ 0ull }; i < s; ++i) {
+				dlimb c{ 0 };
+				for (size_t j{ 0ull }; j < s; ++j) {
+					c += static_cast<dlimb>(t[j]) + static_cast<dlimb>(a[j]) * b[i];
+					t[j] = static_cast<limb>(c);
+					c >>= 32;
+				}
+				c += t[s];
+				t[s] = static_cast<limb>(c);
+				t[s + 1] = static_cast<limb>(c >> 32);
+
+				const limb m{ t[0] * n0inv };
+				c = (static_cast<dlimb>(t[0]) + static_cast<dlimb>(m) * n[0]) >> 32;
+				for (size_t j{ 1ull }; j < s; ++j) {
+					c += static_cast<dlimb>(t[j]) + static_cast<dlimb>(m) * n[j];
+					t[j - 1] = static_cast<limb>(c);
+					c >>= 32;
+				}
+				c += t[s];
+				t[s - 1] = static_cast<limb>(c);
+				t[s] = t[s + 1] + static_cast<limb>(c >> 32);
+			}
+			// the result is less than 2n; subtract n once if necessary
+			if (t[s] != 0 || detail::compare(t.data(), s, n.data(), s) >= 0) {
+				std::int64_t borrow{ 0 };
+				for (size_t j{ 0ull }; j < s; ++j) {
+					borrow += static_cast<std::int64_t>(t[j]) - n[j];
+					t[j] = static_cast<limb>(borrow);
+					borrow >>= 32;
+				}
+			}
+			t.resize(s);
+			return t;
+		}
+
+		/**
+		 * @brief		Modular exponentiation by left-to-right binary square-and-multiply.
+		 * @param base	The number to raise. Must not be negative.
+		 * @param exp	The exponent. Must not be negative.
+		 * @returns		(base ^ exp) mod n
+		 */
+		integer pow(integer const& base, integer const& exp) const
+		{
+			magnitude q, reduced;
+			detail::divmod(base.limbs(), n, q, reduced);
+
+			const magnitude b{ mul(pad(std::move(reduced)), r2) };
+			magnitude one(n.size(), 0);
+			one[0] = 1u;
+			magnitude x{ mul(one, r2) };
+
+			const auto& e{ exp.limbs() };
+			for (size_t i{ e.size() }; i-- > 0;) {
+				for (int bit{ 31 }; bit >= 0; --bit) {
+					x = mul(x, x);
+					if (((e[i] >> bit) & 1u) != 0)
+						x = mul(x, b);
+				}
+			}
+			return integer::from_limbs(mul(x, one)); // convert out of Montgomery form
+		}
+	};
+
+	/**
+	 * @brief		Calculates (base ^ exp) mod m for non-negative operands of any size.
+	 *\n			Odd moduli use Montgomery multiplication; even moduli fall back to squaring & long division.
+	 * @param base	The number to raise. Must not be negative.
+	 * @param exp	The exponent. Must not be negative.
+	 * @param m		The modulus. Must be greater than zero.
+	 * @returns		integer
+	 */
+	inline integer powmod(integer const& base, integer const& exp, integer const& m)
+	{
+		if (m.is_odd())
+			return montgomery{ m }.pow(base, exp);
+
+		integer b{ base % m }, x{ 1 };
+		const auto& e{ exp.limbs() };
+		for (size_t i{ e.size() }; i-- > 0;) {
+			for (int bit{ 31 }; bit >= 0; --bit) {
+				x = (x * x) % m;
+				if (((e[i] >> bit) & 1u) != 0)
+					x = (x * b) % m;
+			}
+		}
+		return x % m;
+	}
+}
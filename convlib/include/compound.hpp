@@ -0,0 +1,139 @@
+/**
+ * @file	compound.hpp
+ * @author	radj307
+ * @brief	Compound units, such as "km/h", "MiB/s", & "ft*lbf", which are products & quotients of the units in units.hpp.
+ */
+#pragma once
+#include "units.hpp"
+
+#include <make_exception.hpp>
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace conv::units {
+	/**
+	 * @struct	Compound
+	 * @brief	A unit parsed from a unit expression, reduced to its dimensions & the transform that converts it to the SI units of those dimensions.
+	 */
+	struct Compound {
+		Dimensions dimensions;
+		affine toBase;
+		// @brief	The unit's symbol, or the expression as it was written when it has more than one term.
+		std::string symbol;
+
+		/// @brief	Returns the transform that converts values in this unit to the given unit.
+		affine to(Compound const& target) const
+		{
+			if (target.dimensions != dimensions)
+				throw make_exception("Can't convert ", dimensions_name(dimensions), " unit \"", symbol, "\" to ", dimensions_name(target.dimensions), " unit \"", target.symbol, "\"!");
+			return toBase.then({ 1.0L / target.toBase.scale, -target.toBase.offset / target.toBase.scale });
+		}
+
+		/// @brief	Returns the text printed after values in this unit, including any separator.
+		std::string suffix() const { return (symbol.starts_with("°") ? "" : " ") + symbol; }
+	};
+
+	/**
+	 * @brief		Parses a unit expression. Terms are units, optionally raised to an integer power with '^' or a superscript ("m^2", "s²"),
+	 *\n			 that are multiplied with '*' or '·', & divided with '/'. Operators apply from left to right, so "kg/m/s" is kg/(m*s).
+	 * @param s		Input string, ex: "km/h", "MiB/s", "ft*lbf", "m/s^2".
+	 * @returns		The parsed unit.
+	 * @throws		ex::except when the expression is invalid, or when a unit with an offset (such as °C) is one of several terms.
+	 */
+	inline Compound parse(std::string_view const s)
+	{
+		if (const auto& unit{ find(s) }; unit.has_value())
+			return{ unit->dimensions(), unit->to_base(), unit->symbol() };
+
+		Compound result{ {}, { 1.0L, 0.0L }, std::string{ s } };
+		int sign{ 1 }; //< -1 when the next term divides
+		for (size_t pos{ 0ull }; pos <= s.size();) {
+			size_t end{ s.find_first_of("*/\xC2", pos) };
+			while (end != std::string_view::npos && s[end] == '\xC2' && !(end + 1ull < s.size() && s[end + 1ull] == '\xB7')) // only the middle dot is an operator
+				end = s.find_first_of("*/\xC2", end + 1ull);
+			if (end == std::string_view::npos)
+				end = s.size();
+			std::string_view term{ s.substr(pos, end - pos) };
+
+			// the exponent
+			int power{ 1 };
+			if (const size_t caret{ term.find('^') }; caret != std::string_view::npos) {
+				const std::string_view exponent{ term.substr(caret + 1ull) };
+				if (const auto& [ptr, ec] { std::from_chars(exponent.data(), exponent.data() + exponent.size(), power) }; ec != std::errc{} || ptr != exponent.data() + exponent.size())
+					throw make_exception("Invalid exponent in unit \"", s, "\": \"", exponent, "\"!");
+				term = term.substr(0ull, caret);
+			}
+			else if (!find(term).has_value() && term.size() > 2ull && term[term.size() - 2ull] == '\xC2' && (term.back() == '\xB2' || term.back() == '\xB3')) { // ² or ³
+				power = term.back() == '\xB2' ? 2 : 3;
+				term.remove_suffix(2ull);
+			}
+
+			if (term != "1") { // as in "1/s"
+				const auto& unit{ find(term) };
+				if (!unit.has_value())
+					throw make_exception("Unrecognized unit \"", term, "\" in \"", s, "\"!");
+				const affine& toBase{ unit->to_base() };
+				if (toBase.offset != 0.0L)
+					throw make_exception("Unit \"", term, "\" has an offset, so it can't be part of the compound unit \"", s, "\"!");
+				result.dimensions = result.dimensions.combine(unit->dimensions(), sign * power);
+				result.toBase.scale *= detail::pow(toBase.scale, sign * power);
+			}
+			else if (power != 1)
+				throw make_exception("Invalid term in unit \"", s, "\": \"", s.substr(pos, end - pos), "\"!");
+
+			if (end == s.size())
+				break;
+			sign = s[end] == '/' ? -1 : 1;
+			pos = end + (s[end] == '\xC2' ? 2ull : 1ull);
+		}
+		return result;
+	}
+
+	/**
+	 * @class	Cache
+	 * @brief	Parses each unit expression once, & remembers the conversions between them, so that records with
+	 *\n		 the same units only cost a hash lookup & a multiplication.
+	 */
+	class Cache {
+		struct string_hash {
+			using is_transparent = void;
+			size_t operator()(std::string_view const s) const noexcept { return std::hash<std::string_view>{}(s); }
+		};
+
+	public:
+		/// @brief	A conversion between two units.
+		struct Plan {
+			affine transform;
+			Compound const* from;
+			Compound const* to;
+		};
+
+	private:
+		std::unordered_map<std::string, Compound, string_hash, std::equal_to<>> units;
+		std::unordered_map<std::string, Plan, string_hash, std::equal_to<>> plans;
+		std::string key;
+
+	public:
+		/// @brief	Returns the parsed unit expression.
+		Compound const& get(std::string_view const s)
+		{
+			if (const auto& it{ units.find(s) }; it != units.end())
+				return it->second;
+			return units.emplace(std::string{ s }, parse(s)).first->second;
+		}
+
+		/// @brief	Returns the conversion from one unit expression to another.
+		Plan const& plan(std::string_view const from, std::string_view const to)
+		{
+			key.assign(from).push_back('\n'); //< units never contain line breaks
+			key.append(to);
+			if (const auto& it{ plans.find(key) }; it != plans.end())
+				return it->second;
+			Compound const& in{ get(from) }, & out{ get(to) };
+			return plans.emplace(key, Plan{ in.to(out), &in, &out }).first->second;
+		}
+	};
+}
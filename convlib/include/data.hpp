@@ -7,6 +7,9 @@
 #include <utility>
 
 namespace data {
+	/// @brief The ratio between consecutive data size units. (1 kB == 1024 B) This is shared by the unit table in units.hpp.
+	inline constexpr long double UNIT_RATIO{ 1024.0L };
+
 	/**
 	 * @struct Unit
 	 * @brief Represents a digital data size unit, from bytes to yottabytes.
@@ -125,7 +128,7 @@ namespace data {
 			// difference exponent = target size - my size
 			const auto diff_exp{ static_cast<long double>(size.operator unsigned int()) - static_cast<long double>(_type.operator unsigned int()) };
 			// divisor = 1024 ^ difference
-			const auto div{ pow(1024.0, diff_exp) };
+			const auto div{ pow(UNIT_RATIO, diff_exp) };
 
 			if (div == 0.0)
 				throw make_exception("Size::convert_to()\tCan't divide by zero!");
@@ -0,0 +1,256 @@
+/**
+ * @file	duration.hpp
+ * @author	radj307
+ * @brief	Durations, such as "250ms" & "1h23m4.5s", stored as a signed 64-bit count of nanoseconds.
+ *\n		Conversions between units are exact integer arithmetic; floating-point is only used to print fractions of a unit.
+ */
+#pragma once
+#include "metric.hpp"
+#include "wideint.hpp"
+#include "format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace conv::duration {
+	/**
+	 * @struct	Unit
+	 * @brief	A unit of time, & the number of nanosecond ticks in one of it.
+	 */
+	struct Unit {
+		std::string_view symbol;
+		std::int64_t ticks;
+	};
+
+	namespace detail {
+		inline constexpr std::int64_t pow10(int const exponent) noexcept
+		{
+			std::int64_t result{ 1 };
+			for (int i{ 0 }; i < exponent; ++i)
+				result *= 10;
+			return result;
+		}
+		/// @brief	Returns a metric unit of seconds, ex: "ms" for milliseconds.
+		inline constexpr Unit si(metric::Prefix const prefix, std::string_view const symbol) noexcept
+		{
+			return{ symbol, pow10(static_cast<int>(prefix) - static_cast<int>(metric::Prefix::NANO)) };
+		}
+
+		inline constexpr bool is_digit(char const c) noexcept { return c >= '0' && c <= '9'; }
+		// bytes above 0x7F are part of "µs" & "μs"
+		inline constexpr bool is_unit_char(char const c) noexcept { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || static_cast<unsigned char>(c) > 0x7F; }
+
+		/// @brief	Writes an unsigned integer. The buffer must have room for 20 characters.
+		inline char* write_integer(char* first, std::uint64_t value) noexcept
+		{
+			char digits[20];
+			char* p{ digits + sizeof(digits) };
+			do {
+				*--p = static_cast<char>('0' + value % 10u);
+				value /= 10u;
+			} while (value != 0u);
+			for (; p != digits + sizeof(digits); ++p)
+				*first++ = *p;
+			return first;
+		}
+		/// @brief	Writes a fraction of a unit whose tick count is a power of ten, without trailing zeros. ex: ".5" for 500ms of seconds.
+		inline char* write_fraction(char* first, std::uint64_t remainder, std::uint64_t scale) noexcept
+		{
+			if (remainder == 0u)
+				return first;
+			*first++ = '.';
+			for (scale /= 10u; remainder != 0u; scale /= 10u) {
+				*first++ = static_cast<char>('0' + remainder / scale);
+				remainder %= scale;
+			}
+			return first;
+		}
+	}
+
+	// "m" is minutes, not meters, so that compound durations like "1h23m" read naturally
+	inline constexpr std::array UNITS{
+		detail::si(metric::Prefix::NANO, "ns"),
+		detail::si(metric::Prefix::MICRO, "us"),
+		detail::si(metric::Prefix::MICRO, "µs"),	// micro sign
+		detail::si(metric::Prefix::MICRO, "μs"),	// greek mu
+		detail::si(metric::Prefix::MILLI, "ms"),
+		detail::si(metric::Prefix::BASE, "s"),
+		detail::si(metric::Prefix::BASE, "sec"),
+		Unit{ "m", 60'000'000'000ll },
+		Unit{ "min", 60'000'000'000ll },
+		Unit{ "h", 3'600'000'000'000ll },
+		Unit{ "hr", 3'600'000'000'000ll },
+		Unit{ "d", 86'400'000'000'000ll },
+		Unit{ "w", 604'800'000'000'000ll },
+	};
+
+	/**
+	 * @brief			Finds a unit by its symbol.
+	 * @param symbol	The unit's symbol, ex: "ms", "h".
+	 * @returns			A pointer to the unit, or nullptr when there isn't one with the given symbol.
+	 */
+	inline constexpr Unit const* find(std::string_view const symbol) noexcept
+	{
+		for (const auto& unit : UNITS)
+			if (unit.symbol == symbol)
+				return &unit;
+		return nullptr;
+	}
+
+	/**
+	 * @brief			Parses a duration. Every number must be followed by a unit, & numbers in several units are added together.
+	 *\n				Fractions are converted to ticks exactly & rounded to the nearest nanosecond once; digits past the 18th are ignored.
+	 * @param first		The start of the input.
+	 * @param last		The end of the input.
+	 * @param ticks		Receives the duration in nanoseconds.
+	 * @returns			A std::from_chars_result, where ptr is the end of the parsed characters. ec is std::errc::invalid_argument when the
+	 *\n				 input doesn't start with a duration, or std::errc::result_out_of_range when it doesn't fit in 64 bits.
+	 */
+	inline std::from_chars_result parse(const char* first, const char* const last, std::int64_t& ticks) noexcept
+	{
+		const char* const begin{ first };
+		const bool negative{ first != last && *first == '-' };
+		if (first != last && (*first == '-' || *first == '+'))
+			++first;
+		const std::uint64_t limit{ static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + (negative ? 1u : 0u) };
+
+		std::uint64_t total{ 0u };
+		const char* end{ begin }; //< the end of the last complete component
+		while (first != last) {
+			// the number
+			const char* p{ first };
+			std::uint64_t whole{ 0u };
+			for (; p != last && detail::is_digit(*p); ++p) {
+				if (whole > (std::numeric_limits<std::uint64_t>::max() - 9u) / 10u)
+					return{ p, std::errc::result_out_of_range };
+				whole = whole * 10u + static_cast<unsigned>(*p - '0');
+			}
+			bool hasDigits{ p != first };
+			std::uint64_t fraction{ 0u }, scale{ 1u };
+			if (p != last && *p == '.') {
+				for (++p; p != last && detail::is_digit(*p); ++p, hasDigits = true) {
+					if (scale < 1'000'000'000'000'000'000ull) {
+						fraction = fraction * 10u + static_cast<unsigned>(*p - '0');
+						scale *= 10u;
+					}
+				}
+			}
+			if (!hasDigits)
+				break;
+
+			// the unit
+			const char* const unitBegin{ p };
+			while (p != last && detail::is_unit_char(*p))
+				++p;
+			const Unit* const unit{ find({ unitBegin, static_cast<size_t>(p - unitBegin) }) };
+			if (unit == nullptr)
+				break;
+
+			const std::uint64_t unitTicks{ static_cast<std::uint64_t>(unit->ticks) };
+			const wideint::u128 product{ wideint::mul(whole, unitTicks) };
+			if (product.hi != 0u || product.lo > limit - total)
+				return{ p, std::errc::result_out_of_range };
+			total += product.lo;
+			if (fraction != 0u) {
+				// fraction / scale < 1, so the quotient always fits in 64 bits
+				std::uint64_t remainder;
+				std::uint64_t part{ wideint::div(wideint::mul(fraction, unitTicks), scale, remainder) };
+				if (remainder >= scale - remainder) // round half up
+					++part;
+				if (part > limit - total)
+					return{ p, std::errc::result_out_of_range };
+				total += part;
+			}
+			first = end = p;
+		}
+		if (end == begin)
+			return{ begin, std::errc::invalid_argument };
+
+		ticks = negative ? static_cast<std::int64_t>(0u - total) : static_cast<std::int64_t>(total);
+		return{ end, std::errc{} };
+	}
+
+	/**
+	 * @brief			Returns a duration as the number of the given unit, ex: 5004.5 for 1h23m24.5s in seconds.
+	 * @param ticks		The duration in nanoseconds.
+	 * @param unit		The unit to return the duration in.
+	 */
+	inline constexpr double count(std::int64_t const ticks, Unit const& unit) noexcept
+	{
+		// the whole & fractional parts are converted separately, so that large durations keep their fraction
+		return static_cast<double>(ticks / unit.ticks) + static_cast<double>(ticks % unit.ticks) / static_cast<double>(unit.ticks);
+	}
+
+	/**
+	 * @brief			Writes a duration as the number of the given unit, ex: "5004.5" for 1h23m24.5s in seconds.
+	 *\n				Whole numbers are written exactly; fractions are written with the given format.
+	 * @param first		Output buffer.
+	 * @param last		The end of the output buffer.
+	 * @param ticks		The duration in nanoseconds.
+	 * @param unit		The unit to write the duration in.
+	 * @param fmt		The format of fractional values.
+	 * @returns			A pointer to the end of the written characters, or nullptr if the buffer was too small.
+	 */
+	inline char* format(char* first, char* last, std::int64_t const ticks, Unit const& unit, FloatFormat const& fmt) noexcept
+	{
+		if (ticks % unit.ticks != 0)
+			return conv::format(first, last, count(ticks, unit), fmt);
+		if (last - first < 21)
+			return nullptr;
+		if (ticks < 0)
+			*first++ = '-';
+		return detail::write_integer(first, (ticks < 0 ? 0u - static_cast<std::uint64_t>(ticks) : static_cast<std::uint64_t>(ticks)) / static_cast<std::uint64_t>(unit.ticks));
+	}
+
+	/**
+	 * @brief			Writes a duration in compound form, ex: "1h23m4.5s". Durations shorter than a second are written in the
+	 *\n				 largest unit that keeps them above 1, ex: "250ms", "1.5us". Every digit is exact.
+	 * @param first		Output buffer.
+	 * @param last		The end of the output buffer.
+	 * @param ticks		The duration in nanoseconds.
+	 * @returns			A pointer to the end of the written characters, or nullptr if the buffer was too small.
+	 */
+	inline char* format(char* first, char* last, std::int64_t const ticks) noexcept
+	{
+		// the longest duration is "-106751d23h47m16.854775808s"
+		if (last - first < 28)
+			return nullptr;
+		if (ticks < 0)
+			*first++ = '-';
+		std::uint64_t value{ ticks < 0 ? 0u - static_cast<std::uint64_t>(ticks) : static_cast<std::uint64_t>(ticks) };
+
+		constexpr std::uint64_t second{ 1'000'000'000u };
+		if (value < second) {
+			std::uint64_t scale{ 1u };
+			std::string_view symbol{ "ns" };
+			if (value == 0u)
+				symbol = "s";
+			else if (value >= 1'000'000u)
+				scale = 1'000'000u, symbol = "ms";
+			else if (value >= 1'000u)
+				scale = 1'000u, symbol = "us";
+			first = detail::write_fraction(detail::write_integer(first, value / scale), value % scale, scale);
+			return std::copy(symbol.begin(), symbol.end(), first);
+		}
+
+		constexpr std::array<std::pair<std::uint64_t, char>, 3ull> parts{ { { 86'400u * second, 'd' }, { 3'600u * second, 'h' }, { 60u * second, 'm' } } };
+		for (const auto& [ticksPer, symbol] : parts) {
+			if (value >= ticksPer) {
+				first = detail::write_integer(first, value / ticksPer);
+				*first++ = symbol;
+				value %= ticksPer;
+			}
+		}
+		if (value != 0u) {
+			first = detail::write_fraction(detail::write_integer(first, value / second), value % second, second);
+			*first++ = 's';
+		}
+		return first;
+	}
+}
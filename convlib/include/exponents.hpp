@@ -1,82 +1,433 @@
 #pragma once
 #include "base.hpp"
+#include "bigint.hpp"
+#include "format.hpp"
+#include "modulo.hpp"
 
 #include <str.hpp>
 #include <var.hpp>
 
 #include <ostream>
+#include <cctype>
 #include <concepts>
 #include <variant>
-#include <regex>
+#include <charconv>
+#include <utility>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 namespace exponents {
 
-	template<typename T> concept accepted_by_pow_func = requires()
-	{
-		std::pow(std::declval<T>(), std::declval<T>());
+	/// @brief	Integer results that would need more bits than this are calculated with floating-point instead.
+	inline constexpr size_t MAX_EXACT_BITS{ 1ull << 24 };
+
+	/// @brief	Numeric value produced by the exponent evaluator. Integers are kept exact & are promoted to
+	///			arbitrary precision when they no longer fit in a long long.
+	struct Number : std::variant<long long, long double, bigint::integer> {
+		using variant::variant;
 	};
 
-	struct Pow {
-		std::string number, exponent;
-	protected:
-		static WINCONSTEXPR long long getBase10(std::string const& s)
+	/// @brief	Returns true when the given number holds an integral value.
+	inline bool is_integral(Number const& n) noexcept { return n.index() != 1; }
+
+	/// @brief	Converts the given number to floating-point.
+	inline long double to_float(Number const& n) noexcept
+	{
+		return std::visit([](auto&& v) -> long double {
+			if constexpr (std::same_as<std::decay_t<decltype(v)>, bigint::integer>)
+				return v.to_long_double();
+			else return static_cast<long double>(v);
+		}, n);
+	}
+
+	/// @brief	Converts the given integral number to a big integer.
+	inline bigint::integer to_big(Number const& n)
+	{
+		if (const auto* i{ std::get_if<long long>(&n) })
+			return *i;
+		return std::get<bigint::integer>(n);
+	}
+
+	/// @brief	Returns the smallest Number type that can hold the given big integer.
+	inline Number shrink(bigint::integer&& big)
+	{
+		if (big.fits_ll())
+			return big.to_ll();
+		return std::move(big);
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, Number const& n)
+	{
+		std::visit([&os](auto&& v) {
+			if constexpr (std::floating_point<std::decay_t<decltype(v)>>)
+				os << conv::formatted{ v };
+			else os << v;
+		}, n);
+		return os;
+	}
+
+	/**
+	 * @brief		Integer exponentiation by squaring, with overflow checking. This is the fast path for pow().
+	 * @param base	The number to raise.
+	 * @param exp	The (non-negative) exponent.
+	 * @returns		The exact result, or std::nullopt if it doesn't fit in a long long.
+	 */
+	inline std::optional<long long> checked_pow(long long const base, unsigned long long exp) noexcept
+	{
+		const bool negative{ base < 0 && (exp & 1ull) != 0 };
+		const unsigned long long limit{ static_cast<unsigned long long>(std::numeric_limits<long long>::max()) + (negative ? 1ull : 0ull) };
+		unsigned long long b{ base < 0 ? 0ull - static_cast<unsigned long long>(base) : static_cast<unsigned long long>(base) };
+		unsigned long long result{ 1ull };
+
+		while (exp != 0) {
+			if ((exp & 1ull) != 0) {
+				if (b != 0 && result > limit / b)
+					return std::nullopt;
+				result *= b;
+			}
+			if ((exp >>= 1) != 0) {
+				if (b > 0xFFFFFFFFull) // b * b would overflow
+					return std::nullopt;
+				b *= b;
+			}
+		}
+		if (negative)
+			return static_cast<long long>(0ull - result);
+		return static_cast<long long>(result);
+	}
+
+	/**
+	 * @brief		Raise a number to a power, keeping the result integral whenever the operands allow it.
+	 *\n			Integer powers are calculated with checked 64-bit arithmetic first, and are promoted to
+	 *\n			arbitrary precision if that overflows.
+	 * @param base	The number to raise.
+	 * @param exp	The exponent.
+	 * @returns		Number
+	 */
+	inline Number pow(Number const& base, Number const& exp)
+	{
+		if (is_integral(base) && is_integral(exp)) {
+			const auto* b{ std::get_if<long long>(&base) };
+			const auto* e{ std::get_if<long long>(&exp) };
+
+			if (b != nullptr && (*b == 0 || *b == 1 || *b == -1)) { // trivial bases never overflow, regardless of exponent size
+				const bool expNegative{ e == nullptr ? std::get<bigint::integer>(exp).is_negative() : *e < 0 };
+				const bool expOdd{ e == nullptr ? std::get<bigint::integer>(exp).is_odd() : (*e & 1ll) != 0 };
+				if (*b == 0)
+					return expNegative ? Number{ std::numeric_limits<long double>::infinity() } : Number{ (e != nullptr && *e == 0) ? 1ll : 0ll };
+				return (*b == -1 && expOdd) ? -1ll : 1ll;
+			}
+			if (e != nullptr && *e >= 0) {
+				const auto uexp{ static_cast<unsigned long long>(*e) };
+				if (b != nullptr) {
+					if (const auto& result{ checked_pow(*b, uexp) }; result.has_value())
+						return result.value();
+				}
+				// promote to arbitrary precision, as long as the result has a sane size
+				const auto& big{ to_big(base) };
+				if (uexp <= MAX_EXACT_BITS / big.bit_length())
+					return shrink(bigint::pow(big, uexp));
+			}
+		}
+		return std::pow(to_float(base), to_float(exp));
+	}
+
+	/**
+	 * @brief		Negate a number.
+	 * @param n		The number to negate.
+	 * @returns		Number
+	 */
+	inline Number negate(Number const& n)
+	{
+		if (const auto* i{ std::get_if<long long>(&n) }) {
+			if (*i != std::numeric_limits<long long>::min())
+				return -*i;
+			return -bigint::integer{ *i };
+		}
+		else if (const auto* big{ std::get_if<bigint::integer>(&n) })
+			return shrink(-*big);
+		return -std::get<long double>(n);
+	}
+
+	/**
+	 * @brief		Calculate the remainder of a division, using the same semantics as modulo::Calculate.
+	 * @param l		The dividend.
+	 * @param r		The divisor.
+	 * @returns		Number
+	 */
+	inline Number mod(Number const& l, Number const& r)
+	{
+		if (!is_integral(l) || !is_integral(r))
+			return modulo::Calculate<modulo::FloatT>(to_float(l), to_float(r)).getResult();
+
+		const auto* li{ std::get_if<long long>(&l) };
+		const auto* ri{ std::get_if<long long>(&r) };
+		if (li != nullptr && ri != nullptr) {
+			if (*ri == -1ll) // prevent overflow when l is the minimum value
+				return 0ll;
+			return modulo::Calculate<modulo::IntT>(*li, *ri).getResult();
+		}
+		const auto& divisor{ to_big(r) };
+		if (divisor.is_zero())
+			throw make_exception("Cannot divide by zero!");
+		return shrink(to_big(l) % divisor);
+	}
+
+	/**
+	 * @brief		Calculate (base ^ exp) % m without calculating the full power, when possible.
+	 *\n			Integer operands use modular exponentiation with Montgomery multiplication; anything else falls back to pow() & mod().
+	 * @param base	The number to raise.
+	 * @param exp	The exponent.
+	 * @param m		The divisor.
+	 * @returns		Number
+	 */
+	inline Number powmod(Number const& base, Number const& exp, Number const& m)
+	{
+		if (is_integral(base) && is_integral(exp) && is_integral(m)) {
+			if (const auto& e{ to_big(exp) }; !e.is_negative())
+				return shrink(modulo::powmod(to_big(base), e, to_big(m)));
+		}
+		return mod(pow(base, exp), m);
+	}
+
+	/**
+	 * @brief		Parse a single numeric literal. Accepts decimal integers & floating-points, as well as
+	 *\n			binary ("0b"), octal ("\") and hexadecimal ("0x") integers.
+	 * @param s		Input string, without any surrounding whitespace.
+	 * @returns		Number
+	 */
+	inline Number parse_number(std::string_view const s)
+	{
+		int radix{ 10 };
+		std::string_view digits{ s };
+		if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+			radix = 16, digits.remove_prefix(2);
+		else if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'b' || digits[1] == 'B'))
+			radix = 2, digits.remove_prefix(2);
+		else if (digits.size() > 1 && digits[0] == '\\')
+			radix = 8, digits.remove_prefix(1);
+
+		const char* const end{ digits.data() + digits.size() };
+
+		if (radix == 10 && digits.find_first_of(".eE") != std::string_view::npos) {
+			long double value{};
+			if (const auto& [ptr, ec] { std::from_chars(digits.data(), end, value) }; ec == std::errc{} && ptr == end)
+				return value;
+		}
+		else {
+			long long value{};
+			if (const auto& [ptr, ec] { std::from_chars(digits.data(), end, value, radix) }; ptr == end) {
+				if (ec == std::errc{})
+					return value;
+				else if (ec == std::errc::result_out_of_range)
+					return bigint::integer::parse(digits, static_cast<unsigned>(radix));
+			}
+		}
+		throw make_exception("Invalid number '", s, "'");
+	}
+
+	/**
+	 * @struct	expression
+	 * @brief	A parsed exponent expression. Nodes are stored in a flat vector & refer to their operands by index.
+	 *\n		Value nodes refer to the source string, so an expression must not outlive its input.
+	 */
+	struct expression {
+		enum class NodeType : unsigned char {
+			VALUE,
+			NEGATE,
+			POW,
+			MOD,
+		};
+		struct node {
+			NodeType type;
+			// @brief	True when this node was enclosed in brackets in the source string.
+			bool enclosed{ false };
+			// @brief	The source text of a VALUE node.
+			std::string_view text;
+			Number value;
+			size_t left{ 0ull }, right{ 0ull };
+		};
+
+		std::vector<node> nodes;
+		size_t root{ 0ull };
+
+		/// @brief	Evaluate the node at the given index.
+		Number evaluate(size_t const index) const
 		{
-			switch (base::detectBase(s)) {
-			case base::enumerator::Base::BINARY:
-				return str::toBase10(s, 2);
-			case base::enumerator::Base::OCTAL:
-				return str::toBase10(s, 8);
-			case base::enumerator::Base::DECIMAL:
-				return str::stoll(s);
-			case base::enumerator::Base::HEXADECIMAL:
-				return str::toBase10(s, 16);
+			const auto& n{ nodes[index] };
+			switch (n.type) {
+			case NodeType::VALUE:
+				return n.value;
+			case NodeType::NEGATE:
+				return negate(evaluate(n.left));
+			case NodeType::POW:
+				return pow(evaluate(n.left), evaluate(n.right));
+			case NodeType::MOD:
+				if (const auto& l{ nodes[n.left] }; l.type == NodeType::POW) // a ^ b % m
+					return powmod(evaluate(l.left), evaluate(l.right), evaluate(n.right));
+				else if (l.type == NodeType::NEGATE && nodes[l.left].type == NodeType::POW) // -a ^ b % m == -(a ^ b % m)
+					return negate(powmod(evaluate(nodes[l.left].left), evaluate(nodes[l.left].right), evaluate(n.right)));
+				return mod(evaluate(n.left), evaluate(n.right));
 			default:
-				return 0;
+				throw make_exception("Invalid expression node type!");
 			}
 		}
-		template<accepted_by_pow_func T>
-		T getResult(std::function<T(std::string)> const& converter) const
+		/// @brief	Evaluate the whole expression.
+		Number evaluate() const { return evaluate(root); }
+	};
+
+	/**
+	 * @class	Parser
+	 * @brief	Recursive-descent parser for exponent expressions.
+	 *\n		expr    := unary { '%' unary }
+	 *\n		unary   := '-' unary | primary [ '^' unary ]
+	 *\n		primary := NUMBER | '(' expr ')'
+	 *\n		The caret operator is right-associative, so "2 ^ 3 ^ 2" is equal to "2 ^ (3 ^ 2)".
+	 *\n		The modulo operator has the lowest precedence, so "a ^ b % m" is calculated with modular exponentiation.
+	 */
+	class Parser {
+		std::string_view src;
+		size_t pos{ 0ull };
+		expression expr;
+
+		void skip_whitespace() noexcept
 		{
-			return std::pow(converter(number), converter(exponent));
+			while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos])))
+				++pos;
 		}
-	public:
-		WINCONSTEXPR Pow() {}
-		WINCONSTEXPR Pow(std::string const& number, std::string const& exponent) : number{ number }, exponent{ exponent } {}
-		WINCONSTEXPR Pow(std::string&& number, std::string&& exponent) : number{ std::move(number) }, exponent{ std::move(exponent) } {}
-		/// @brief	Returns true when the number or exponent should be parsed as a floating-point number.
-		bool hasFloatingPoint() const
+		char peek() noexcept
 		{
-			return number.find('.') < number.size() || exponent.find('.') < exponent.size();
+			skip_whitespace();
+			return pos < src.size() ? src[pos] : '\0';
 		}
-		bool hasNegative() const
+		size_t push(expression::node&& n)
 		{
-			static const std::string search_str{ "-" };
-			return number.find_first_of(search_str) < number.find_first_not_of(search_str) || exponent.find_first_of(search_str) < exponent.find_first_not_of(search_str);
+			expr.nodes.emplace_back(std::move(n));
+			return expr.nodes.size() - 1ull;
 		}
-		template<std::signed_integral TReturn>
-		TReturn getResult() const
+
+		size_t parse_primary()
+		{
+			const char c{ peek() };
+			if (c == '(') {
+				++pos;
+				const auto index{ parse_expression() };
+				if (peek() != ')')
+					throw make_exception("Unmatched opening bracket in '", src, "'");
+				++pos;
+				expr.nodes[index].enclosed = true;
+				return index;
+			}
+			else if (c == '\0' || c == ')' || c == '^' || c == '%')
+				throw make_exception("Missing operand in '", src, "'");
+
+			const auto begin{ pos };
+			while (pos < src.size() && (std::isalnum(static_cast<unsigned char>(src[pos])) || src[pos] == '.' || src[pos] == '\\'))
+				++pos;
+			if (pos == begin)
+				throw make_exception("Unexpected character '", c, "' in '", src, "'");
+
+			const auto text{ src.substr(begin, pos - begin) };
+			return push({ .type = expression::NodeType::VALUE, .text = text, .value = parse_number(text) });
+		}
+		size_t parse_unary()
+		{
+			if (peek() == '-') {
+				++pos;
+				const auto operand{ parse_unary() };
+				return push({ .type = expression::NodeType::NEGATE, .left = operand });
+			}
+			const auto left{ parse_primary() };
+			if (peek() == '^') {
+				++pos;
+				if (const char c{ peek() }; c == '\0' || c == ')')
+					throw make_exception("Missing exponent in '", src, "'");
+				const auto right{ parse_unary() };
+				return push({ .type = expression::NodeType::POW, .left = left, .right = right });
+			}
+			return left;
+		}
+		size_t parse_expression()
+		{
+			size_t left{ parse_unary() };
+			while (peek() == '%') {
+				++pos;
+				if (const char c{ peek() }; c == '\0' || c == ')')
+					throw make_exception("Missing divisor in '", src, "'");
+				const auto right{ parse_unary() };
+				left = push({ .type = expression::NodeType::MOD, .left = left, .right = right });
+			}
+			return left;
+		}
+
+	public:
+		Parser(std::string_view const input) : src{ input } {}
+
+		/**
+		 * @brief	Parse the input string.
+		 * @returns	expression
+		 */
+		expression parse()
+		{
+			expr.nodes.reserve(8ull);
+			expr.root = parse_expression();
+			if (const char c{ peek() }; c != '\0')
+				throw make_exception("Unexpected character '", c, "' in '", src, "'");
+			return std::move(expr);
+		}
+	};
+
+	/**
+	 * @brief		Parse a single exponent expression.
+	 * @param input	Input string. This must outlive the returned expression.
+	 * @returns		expression
+	 */
+	inline expression parse(std::string_view const input)
+	{
+		return Parser(input).parse();
+	}
+
+	/**
+	 * @struct	Pow
+	 * @brief	A single power operation with string operands.
+	 */
+	struct Pow {
+		std::string number, exponent;
+
+		WINCONSTEXPR Pow() {}
+		WINCONSTEXPR Pow(std::string const& number, std::string const& exponent) : number{ number }, exponent{ exponent } {}
+		WINCONSTEXPR Pow(std::string&& number, std::string&& exponent) : number{ std::move(number) }, exponent{ std::move(exponent) } {}
+		/// @brief	Returns the exact result of this operation.
+		Number getNumber() const
 		{
-			return static_cast<TReturn>(this->getResult<long long>(str::stoll));
+			return pow(exponents::parse(number).evaluate(), exponents::parse(exponent).evaluate());
 		}
-		template<std::unsigned_integral TReturn>
+		/// @brief	Returns the result of this operation as an integer.
+		/// @throws	ex::except	The result doesn't fit in TReturn.
+		template<std::integral TReturn>
 		TReturn getResult() const
 		{
-			return static_cast<TReturn>(this->getResult<long long>(str::stoull));
+			const auto& result{ getNumber() };
+			if (const auto* i{ std::get_if<long long>(&result) }; i != nullptr && std::in_range<TReturn>(*i))
+				return static_cast<TReturn>(*i);
+			else if (const auto* big{ std::get_if<bigint::integer>(&result) }; big != nullptr && !big->is_negative() && big->bit_length() <= 64ull && std::in_range<TReturn>(big->magnitude_ull()))
+				return static_cast<TReturn>(big->magnitude_ull());
+			else if (const auto* f{ std::get_if<long double>(&result) }; f != nullptr && *f >= static_cast<long double>(std::numeric_limits<TReturn>::min()) && *f <= static_cast<long double>(std::numeric_limits<TReturn>::max()))
+				return static_cast<TReturn>(*f);
+			throw make_exception("The result of ", number, " ^ ", exponent, " is out of range!");
 		}
+		/// @brief	Returns the result of this operation as a floating-point.
 		template<std::floating_point TReturn>
 		TReturn getResult() const
 		{
-			return static_cast<TReturn>(this->getResult<long double>(str::stold));
+			return static_cast<TReturn>(to_float(getNumber()));
 		}
 		template<var::streamable... Ts>
 		std::string getResultString(Ts&&... stream_formatting) const
 		{
-			if (hasFloatingPoint())
-				return str::stringify(std::forward<Ts>(stream_formatting)..., getResult<long double>());
-			else if (hasNegative())
-				return str::stringify(std::forward<Ts>(stream_formatting)..., getResult<long long>());
-			else
-				return str::stringify(std::forward<Ts>(stream_formatting)..., getResult<unsigned long long>());
+			return str::stringify(std::forward<Ts>(stream_formatting)..., getNumber());
 		}
 	};
 }
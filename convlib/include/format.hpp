@@ -0,0 +1,234 @@
+/**
+ * @file	format.hpp
+ * @author	radj307
+ * @brief	Fast floating-point to text conversion, for modes that print large numbers of values.
+ */
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+
+namespace conv {
+	namespace detail {
+		// @brief	Every power of ten that is exactly representable as a double.
+		inline constexpr double POW10[]{
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+
+		// @brief	Calls std::to_chars in general notation, returning nullptr instead of last when the buffer is too small.
+		template<std::floating_point T>
+		inline char* to_chars_general(char* first, char* last, T const value, int precision) noexcept
+		{
+			const auto [ptr, ec] { std::to_chars(first, last, value, std::chars_format::general, precision) };
+			return ec == std::errc{} ? ptr : nullptr;
+		}
+	}
+
+	/**
+	 * @brief				Writes a value in the same format as printf's "%g" (and std::ostream's default format).
+	 *\n					When precision is at most 9 & the value would be printed without an exponent, it is formatted with
+	 *\n					 integer arithmetic, which is several times faster than std::to_chars & gives the same result.
+	 *\n					All other values, and values that are too close to a rounding tie to be decided this way, are passed to std::to_chars.
+	 * @param first			Output buffer.
+	 * @param last			The end of the output buffer.
+	 * @param value			Input value.
+	 * @param precision		The number of significant digits.
+	 * @returns				A pointer to the end of the written characters, or nullptr if the buffer was too small.
+	 */
+	template<std::floating_point T>
+	inline char* format_general(char* first, char* last, T const value, int precision = 6) noexcept
+	{
+		precision = std::max(precision, 1);
+		const double abs{ std::fabs(static_cast<double>(value)) };
+		// handles zero, infinity, & NaN as well as values that need an exponent
+		if (precision > 9 || !(abs >= 1e-4 && abs < 1e15) || last - first < 24)
+			return detail::to_chars_general(first, last, value, precision);
+
+		// find the decimal exponent
+		int exp{ static_cast<int>(std::upper_bound(detail::POW10, detail::POW10 + 15, abs) - detail::POW10) - 1 };
+		if (exp < 0) // abs < 1
+			exp = abs >= 1e-1 ? -1 : abs >= 1e-2 ? -2 : abs >= 1e-3 ? -3 : -4;
+
+		// scale to an integer with exactly 'precision' digits
+		const int shift{ precision - 1 - exp };
+		const double scaled{ shift >= 0 ? abs * detail::POW10[shift] : abs / detail::POW10[-shift] };
+		const double whole{ std::floor(scaled) };
+		// scaled is below 1e9, so it is within 1e-7 of the exact product; anything closer to a tie than that can't be rounded reliably
+		if (std::fabs(scaled - whole - 0.5) < 1e-6)
+			return detail::to_chars_general(first, last, value, precision);
+		std::uint64_t digits{ static_cast<std::uint64_t>(whole) + (scaled - whole > 0.5) };
+		if (digits >= static_cast<std::uint64_t>(detail::POW10[precision])) { // rounding carried into another digit
+			digits /= 10u;
+			++exp;
+		}
+		if (exp >= precision)
+			return detail::to_chars_general(first, last, value, precision);
+
+		char buf[16];
+		for (int i{ precision - 1 }; i >= 0; --i, digits /= 10u)
+			buf[i] = static_cast<char>('0' + digits % 10u);
+		int count{ precision };
+		while (count > 1 && buf[count - 1] == '0') // remove trailing zeros
+			--count;
+
+		char* out{ first };
+		if (value < 0)
+			*out++ = '-';
+		if (exp >= 0) {
+			const int intDigits{ exp + 1 };
+			for (int i{ 0 }; i < intDigits; ++i)
+				*out++ = i < count ? buf[i] : '0';
+			if (count > intDigits) {
+				*out++ = '.';
+				for (int i{ intDigits }; i < count; ++i)
+					*out++ = buf[i];
+			}
+		}
+		else {
+			*out++ = '0';
+			*out++ = '.';
+			for (int i{ -1 }; i > exp; --i)
+				*out++ = '0';
+			for (int i{ 0 }; i < count; ++i)
+				*out++ = buf[i];
+		}
+		return out;
+	}
+
+	/**
+	 * @struct	FloatFormat
+	 * @brief	Floating-point output options. These have the same meaning as the std::ostream flags they are created from.
+	 */
+	struct FloatFormat {
+		enum class Notation : unsigned char {
+			// @brief	Equivalent to printf's "%g"; the default std::ostream notation.
+			General,
+			// @brief	Equivalent to std::fixed.
+			Fixed,
+			// @brief	Equivalent to std::scientific.
+			Scientific,
+			// @brief	Equivalent to std::hexfloat.
+			Hex,
+		};
+
+		Notation notation{ Notation::General };
+		int precision{ 6 };
+		// @brief	When true, precision is ignored & the shortest representation that round-trips is used instead.
+		bool shortest{ false };
+
+		/// @brief	Returns the index of the std::ios_base::iword that enables the shortest representation for a stream.
+		static int shortest_index()
+		{
+			static const int index{ std::ios_base::xalloc() };
+			return index;
+		}
+
+		/// @brief	Creates a FloatFormat with the same settings as the given stream.
+		static FloatFormat from(std::ios_base& ios)
+		{
+			const auto floatfield{ ios.flags() & std::ios_base::floatfield };
+			return{
+				floatfield == std::ios_base::fixed ? Notation::Fixed
+				: floatfield == std::ios_base::scientific ? Notation::Scientific
+				: floatfield == (std::ios_base::fixed | std::ios_base::scientific) ? Notation::Hex
+				: Notation::General,
+				static_cast<int>(ios.precision()),
+				ios.iword(shortest_index()) != 0
+			};
+		}
+	};
+
+	/// @brief	Stream manipulator that makes conv::formatted values use the shortest representation that round-trips.
+	inline std::ios_base& shortest(std::ios_base& ios)
+	{
+		ios.iword(FloatFormat::shortest_index()) = 1;
+		return ios;
+	}
+
+	/**
+	 * @brief			Writes a floating-point value to a character buffer.
+	 * @param first		Output buffer.
+	 * @param last		The end of the output buffer.
+	 * @param value		Input value.
+	 * @param fmt		Formatting options.
+	 * @returns			A pointer to the end of the written characters, or nullptr if the buffer was too small.
+	 */
+	template<std::floating_point T>
+	inline char* format(char* first, char* last, T const value, FloatFormat const& fmt) noexcept
+	{
+		std::to_chars_result result{ first, std::errc{} };
+		switch (fmt.notation) {
+		case FloatFormat::Notation::General:
+			if (!fmt.shortest)
+				return format_general(first, last, value, fmt.precision);
+			result = std::to_chars(first, last, value);
+			break;
+		case FloatFormat::Notation::Fixed:
+			result = fmt.shortest ? std::to_chars(first, last, value, std::chars_format::fixed) : std::to_chars(first, last, value, std::chars_format::fixed, fmt.precision);
+			break;
+		case FloatFormat::Notation::Scientific:
+			result = fmt.shortest ? std::to_chars(first, last, value, std::chars_format::scientific) : std::to_chars(first, last, value, std::chars_format::scientific, fmt.precision);
+			break;
+		case FloatFormat::Notation::Hex: {
+			// std::hexfloat prints an "0x" prefix, but std::to_chars doesn't
+			if (last - first < 3)
+				return nullptr;
+			char* out{ first };
+			if (std::signbit(value))
+				*out++ = '-';
+			if (std::isfinite(value)) {
+				*out++ = '0';
+				*out++ = 'x';
+			}
+			result = std::to_chars(out, last, std::fabs(value), std::chars_format::hex);
+			break;
+		}
+		}
+		return result.ec == std::errc{} ? result.ptr : nullptr;
+	}
+
+	/**
+	 * @brief			Writes a floating-point value to a string that is large enough for any value & precision.
+	 *\n				This is slower than writing to a fixed-size buffer; use it when conv::format returns nullptr.
+	 * @param value		Input value.
+	 * @param fmt		Formatting options.
+	 * @returns			The formatted value.
+	 */
+	template<std::floating_point T>
+	inline std::string to_string(T const value, FloatFormat const& fmt)
+	{
+		using limits = std::numeric_limits<T>;
+		// fixed notation can write every digit of the largest value & of the smallest subnormal; the others write at most
+		//  max(precision, max_digits10) significant digits, a few leading zeros, & an exponent
+		const size_t digits{ static_cast<size_t>(fmt.notation == FloatFormat::Notation::Fixed ? limits::max_exponent10 + limits::digits - limits::min_exponent : limits::max_digits10) };
+		std::string s(digits + static_cast<size_t>(std::max(fmt.precision, 0)) + 32ull, '\0');
+		const char* const end{ format(s.data(), s.data() + s.size(), value, fmt) };
+		s.resize(end == nullptr ? 0ull : static_cast<size_t>(end - s.data()));
+		return s;
+	}
+
+	/**
+	 * @struct	formatted
+	 * @brief	Inserts a floating-point value into an output stream with conv::format, which is much faster than the stream's
+	 *\n		 own formatting. The stream's floatfield & precision are honored.
+	 */
+	template<std::floating_point T>
+	struct formatted {
+		T value;
+
+		friend std::ostream& operator<<(std::ostream& os, formatted const& f)
+		{
+			char buf[128];
+			if (const char* end{ format(buf, buf + sizeof(buf), f.value, FloatFormat::from(os)) }; end != nullptr)
+				return os.write(buf, end - buf);
+			return os << f.value; // too long for the buffer
+		}
+	};
+	template<std::floating_point T> formatted(T) -> formatted<T>;
+}
@@ -5,6 +5,7 @@
  */
 #pragma once
 #include "metric.hpp"
+#include "rational.hpp"
 
 #include <sysarch.h>
 #include <make_exception.hpp>
@@ -13,6 +14,7 @@
 #include <math.hpp>
 #include <TermAPI.hpp>
 
+#include <array>
 #include <optional>
 #include <iterator>
 #include <algorithm>
@@ -131,28 +133,51 @@ namespace length {
 		const U* const base{ METER };
 	} Metric;
 
+	/**
+	 * @namespace	imperial
+	 * @brief		The length of each imperial unit in feet. These are used by both the Imperial system & the unit table in units.hpp.
+	 */
+	namespace imperial {
+		inline constexpr long double TWIP{ 1.0L / 17280.0L };
+		inline constexpr long double THOU{ 1.0L / 12000.0L };
+		inline constexpr long double BARLEYCORN{ 1.0L / 36.0L };
+		inline constexpr long double INCH{ 1.0L / 12.0L };
+		inline constexpr long double HAND{ 1.0L / 3.0L };
+		inline constexpr long double FOOT{ 1.0L };
+		inline constexpr long double YARD{ 3.0L };
+		inline constexpr long double CHAIN{ 66.0L };
+		inline constexpr long double FURLONG{ 660.0L };
+		inline constexpr long double MILE{ 5280.0L };
+		inline constexpr long double LEAGUE{ 15840.0L };
+		inline constexpr long double FATHOM{ 6.0761L };
+		inline constexpr long double CABLE{ 607.61L };
+		inline constexpr long double NAUTICAL_MILE{ 6076.1L };
+		inline constexpr long double LINK{ 66.0L / 100.0L };
+		inline constexpr long double ROD{ 66.0L / 4.0L };
+	}
+
 	/**
 	 * @struct	Imperial
 	 * @brief	Intra-Imperial-System Conversion Factors. (Relative to Feet)
 	 */
 	static struct : public System { // SystemID::IMPERIAL
 		const std::vector<U> units{
-			{ SystemID::IMPERIAL, static_cast<T>(1.0L / 17280.0L), "Twip" },
-			{ SystemID::IMPERIAL, static_cast<T>(1.0L / 12000.0L), "th", "Thou" },
-			{ SystemID::IMPERIAL, static_cast<T>(1.0L / 36.0L), "Bc", "Barleycorn" },
-			{ SystemID::IMPERIAL, static_cast<T>(1.0L / 12.0L), "\"", "Inch" },
-			{ SystemID::IMPERIAL, static_cast<T>(1.0L / 3.0L), "h", "Hand" },
-			{ SystemID::IMPERIAL, static_cast<T>(1.0L), "\'", "Feet" },
-			{ SystemID::IMPERIAL, static_cast<T>(3.0L), "yd", "Yard" },
-			{ SystemID::IMPERIAL, static_cast<T>(66.0L), "ch", "Chain" },
-			{ SystemID::IMPERIAL, static_cast<T>(660.0L), "fur", "Furlong" },
-			{ SystemID::IMPERIAL, static_cast<T>(5280.0L), "mi", "Mile" },
-			{ SystemID::IMPERIAL, static_cast<T>(15840.0L), "lea", "League" },
-			{ SystemID::IMPERIAL, static_cast<T>(6.0761L), "ftm", "Fathom" },
-			{ SystemID::IMPERIAL, static_cast<T>(607.61L), "Cable" },
-			{ SystemID::IMPERIAL, static_cast<T>(6076.1L), "nmi", "Nautical Mile" },
-			{ SystemID::IMPERIAL, static_cast<T>(66.0L / 100.0L), "Link" },
-			{ SystemID::IMPERIAL, static_cast<T>(66.0L / 4.0L), "rd", "Rod" }
+			{ SystemID::IMPERIAL, imperial::TWIP, "Twip" },
+			{ SystemID::IMPERIAL, imperial::THOU, "th", "Thou" },
+			{ SystemID::IMPERIAL, imperial::BARLEYCORN, "Bc", "Barleycorn" },
+			{ SystemID::IMPERIAL, imperial::INCH, "\"", "Inch" },
+			{ SystemID::IMPERIAL, imperial::HAND, "h", "Hand" },
+			{ SystemID::IMPERIAL, imperial::FOOT, "\'", "Feet" },
+			{ SystemID::IMPERIAL, imperial::YARD, "yd", "Yard" },
+			{ SystemID::IMPERIAL, imperial::CHAIN, "ch", "Chain" },
+			{ SystemID::IMPERIAL, imperial::FURLONG, "fur", "Furlong" },
+			{ SystemID::IMPERIAL, imperial::MILE, "mi", "Mile" },
+			{ SystemID::IMPERIAL, imperial::LEAGUE, "lea", "League" },
+			{ SystemID::IMPERIAL, imperial::FATHOM, "ftm", "Fathom" },
+			{ SystemID::IMPERIAL, imperial::CABLE, "Cable" },
+			{ SystemID::IMPERIAL, imperial::NAUTICAL_MILE, "nmi", "Nautical Mile" },
+			{ SystemID::IMPERIAL, imperial::LINK, "Link" },
+			{ SystemID::IMPERIAL, imperial::ROD, "rd", "Rod" }
 		};
 
 		const U* TWIP{ &units[0] };
@@ -298,6 +323,138 @@ namespace length {
 		return convert_system(in.getSystem(), in.to_base(static_cast<long double>(val)), out.getSystem()) / out.unitcf;
 	}
 
+#if defined(__SIZEOF_INT128__)
+	/**
+	 * @namespace	exact
+	 * @brief		Exact conversion factors, as fractions instead of floating-point numbers, so that conversions never accumulate rounding error.
+	 */
+	namespace exact {
+		/// @brief	Inter-System (Metric:Imperial) Conversion Factor
+		inline constexpr conv::rational FOOT_IN_METERS{ conv::rational::of(381, 1250) };
+		/// @brief	Inter-System (CKUnit:Metric) Conversion Factor
+		inline constexpr conv::rational UNIT_IN_METERS{ conv::rational::of(142875313, 10000000000) };
+		/// @brief	Inter-System (CKUnit:Imperial) Conversion Factor. This is exactly 3/64 ft, which isn't quite UNIT_IN_METERS.
+		inline constexpr conv::rational UNIT_IN_FEET{ conv::rational::of(3, 64) };
+
+		/// @brief	The conversion factor between the base units of every pair of systems, indexed by [input][output] in the same order
+		///\n		as SystemID. These are the same factors that convert_system() uses.
+		inline constexpr std::array<std::array<conv::rational, 3>, 3> SYSTEMS{ {
+			{ conv::rational::of(1, 1), conv::rational::of(1, 1) / FOOT_IN_METERS, conv::rational::of(1, 1) / UNIT_IN_METERS },	// METRIC ->
+			{ FOOT_IN_METERS, conv::rational::of(1, 1), conv::rational::of(1, 1) / UNIT_IN_FEET },	// IMPERIAL ->
+			{ UNIT_IN_METERS, UNIT_IN_FEET, conv::rational::of(1, 1) },	// CREATIONKIT ->
+		} };
+
+		/**
+		 * @struct	Factor
+		 * @brief	The exact length of a unit, in the base unit of its system.
+		 */
+		struct Factor {
+			SystemID system;
+			conv::rational toBase;
+		};
+
+		/// @brief	The length of every unit, in the same order as Metric.units, Imperial.units, & then Bethesda.units.
+		inline constexpr std::array FACTORS{
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::QUECTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::RONTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::YOCTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::ZEPTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::ATTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::FEMTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::PICO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::NANO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::MICRO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::MILLI)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::CENTI)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::DECI)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::BASE)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::DECA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::HECTO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::KILO)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::MEGA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::GIGA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::TERA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::PETA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::EXA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::ZETTA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::YOTTA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::RONNA)) },
+			Factor{ SystemID::METRIC, conv::rational::pow10(static_cast<int>(Prefix::QUETTA)) },
+
+			Factor{ SystemID::IMPERIAL, conv::rational::of(1, 17280) },	// Twip
+			Factor{ SystemID::IMPERIAL, conv::rational::of(1, 12000) },	// Thou
+			Factor{ SystemID::IMPERIAL, conv::rational::of(1, 36) },	// Barleycorn
+			Factor{ SystemID::IMPERIAL, conv::rational::of(1, 12) },	// Inch
+			Factor{ SystemID::IMPERIAL, conv::rational::of(1, 3) },	// Hand
+			Factor{ SystemID::IMPERIAL, conv::rational::of(1, 1) },	// Foot
+			Factor{ SystemID::IMPERIAL, conv::rational::of(3, 1) },	// Yard
+			Factor{ SystemID::IMPERIAL, conv::rational::of(66, 1) },	// Chain
+			Factor{ SystemID::IMPERIAL, conv::rational::of(660, 1) },	// Furlong
+			Factor{ SystemID::IMPERIAL, conv::rational::of(5280, 1) },	// Mile
+			Factor{ SystemID::IMPERIAL, conv::rational::of(15840, 1) },	// League
+			Factor{ SystemID::IMPERIAL, conv::rational::of(60761, 10000) },	// Fathom
+			Factor{ SystemID::IMPERIAL, conv::rational::of(60761, 100) },	// Cable
+			Factor{ SystemID::IMPERIAL, conv::rational::of(60761, 10) },	// Nautical Mile
+			Factor{ SystemID::IMPERIAL, conv::rational::of(66, 100) },	// Link
+			Factor{ SystemID::IMPERIAL, conv::rational::of(66, 4) },	// Rod
+
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::PICO)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::NANO)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::MICRO)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::MILLI)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::CENTI)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::DECI)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::BASE)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::DECA)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::HECTO)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::KILO)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::MEGA)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::GIGA)) },
+			Factor{ SystemID::CREATIONKIT, conv::rational::pow10(static_cast<int>(Prefix::TERA)) },
+		};
+
+		/// @brief	The conversion factor between every pair of units; MATRIX[in][out] converts values in the unit at index in to the unit at index out.
+		///\n		Like convert(), this converts through the base units of both systems. Factors that don't fit in 128 bits (such as quectometers
+		///\n		 to quettameters) are invalid.
+		inline constexpr auto MATRIX{ []() {
+			std::array<std::array<conv::rational, FACTORS.size()>, FACTORS.size()> matrix{};
+			for (size_t in{ 0ull }; in < FACTORS.size(); ++in)
+				for (size_t out{ 0ull }; out < FACTORS.size(); ++out)
+					matrix[in][out] = FACTORS[in].toBase * SYSTEMS[static_cast<size_t>(FACTORS[in].system)][static_cast<size_t>(FACTORS[out].system)] / FACTORS[out].toBase;
+			return matrix;
+		}() };
+
+		/// @brief	Returns the index of the given unit in FACTORS.
+		inline size_t index_of(Unit const& unit)
+		{
+			const auto& find_in{ [&unit](std::vector<Unit> const& units, size_t const offset) {
+				return offset + static_cast<size_t>(std::find(units.begin(), units.end(), unit) - units.begin());
+			} };
+			switch (unit.getSystem()) {
+			case SystemID::METRIC:
+				return find_in(Metric.units, 0ull);
+			case SystemID::IMPERIAL:
+				return find_in(Imperial.units, Metric.units.size());
+			case SystemID::CREATIONKIT:
+				return find_in(Bethesda.units, Metric.units.size() + Imperial.units.size());
+			default:
+				throw make_exception("Unit \"", unit.getSymbol(), "\" doesn't have an exact conversion factor!");
+			}
+		}
+
+		/**
+		 * @brief		Retrieve the exact conversion factor between two units.
+		 * @param in	Input Unit.
+		 * @param out	Output Unit.
+		 * @returns		The fraction that values in the input unit are multiplied by. This is invalid when the conversion can't be done exactly.
+		 */
+		inline conv::rational const& factor(Unit const& in, Unit const& out)
+		{
+			return MATRIX[index_of(in)][index_of(out)];
+		}
+	}
+#endif
+
 	/**
 	 * @brief		Retrieve the unit specified by a string containing the unit's official symbol, or name.
 	 * @param str	Input String. (This is not processed beyond case-conversion)
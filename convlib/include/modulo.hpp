@@ -1,6 +1,15 @@
 #pragma once
+#include "bigint.hpp"
+#include "simd.hpp"
+#include "wideint.hpp"
+
 #include <math.hpp>
 
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
 namespace modulo {
 	using FloatT = long double;
 	using IntT = long long;
@@ -48,4 +57,421 @@ namespace modulo {
 
 		T operator()() const { return getResult(); }
 	};
-}
\ No newline at end of file
+
+	/**
+	 * @struct	Montgomery
+	 * @brief	Montgomery multiplication context for a fixed odd 64-bit modulus, with R = 2^64.
+	 *\n		Values are kept in Montgomery form (x * R mod n) so that each modular multiplication
+	 *\n		only needs multiplies & shifts, instead of a 128-bit division.
+	 */
+	struct Montgomery {
+		using u64 = std::uint64_t;
+
+		/// @brief	The modulus. Always odd.
+		u64 n;
+		/// @brief	n^-1 mod 2^64
+		u64 ninv;
+		/// @brief	R mod n; this is 1 in Montgomery form.
+		u64 one;
+		/// @brief	R^2 mod n; used to convert values into Montgomery form.
+		u64 r2;
+
+	private:
+		/// @brief	Returns the given modulus, or throws when it is even; this runs before any member divides by it.
+		static u64 validate(u64 const modulus)
+		{
+			if ((modulus & 1ull) == 0)
+				throw make_exception("Montgomery multiplication requires an odd modulus!");
+			return modulus;
+		}
+
+	public:
+		Montgomery(u64 const odd_modulus) : n{ validate(odd_modulus) }, ninv{ wideint::inverse(n) }, one{ (0ull - n) % n }, r2{ one }
+		{
+			for (int i{ 0 }; i < 64; ++i) // double (R mod n) 64 times to get R^2 mod n
+				r2 = (r2 >= n - r2) ? r2 - (n - r2) : r2 + r2;
+		}
+
+		/// @brief	Montgomery reduction; returns t * R^-1 mod n. t must be less than n * R.
+		u64 reduce(wideint::u128 const t) const noexcept
+		{
+			const u64 m{ t.lo * ninv };
+			const u64 mn_hi{ wideint::mulhi(m, n) };
+			return t.hi < mn_hi ? t.hi - mn_hi + n : t.hi - mn_hi;
+		}
+		/// @brief	Multiplies two values in Montgomery form.
+		u64 mul(u64 const a, u64 const b) const noexcept { return reduce(wideint::mul(a, b)); }
+		/// @brief	Converts a value into Montgomery form.
+		u64 to_form(u64 const a) const noexcept { return mul(a % n, r2); }
+		/// @brief	Converts a value out of Montgomery form.
+		u64 from_form(u64 const a) const noexcept { return reduce({ a, 0ull }); }
+
+		/**
+		 * @brief		Modular exponentiation by left-to-right binary square-and-multiply.
+		 * @param base	The number to raise. This doesn't have to be reduced.
+		 * @param exp	The exponent's magnitude.
+		 * @returns		(base ^ exp) mod n
+		 */
+		u64 pow(u64 const base, bigint::magnitude const& exp) const noexcept
+		{
+			const u64 b{ to_form(base) };
+			u64 x{ one };
+			for (size_t i{ exp.size() }; i-- > 0;) {
+				for (int bit{ 31 }; bit >= 0; --bit) {
+					x = mul(x, x);
+					if (((exp[i] >> bit) & 1u) != 0)
+						x = mul(x, b);
+				}
+			}
+			return from_form(x) % n; // n == 1 leaves one == 0, but keep the result in range regardless
+		}
+	};
+
+	/**
+	 * @brief		Calculates (base ^ exp) mod m for a 64-bit modulus.
+	 *\n			Odd moduli use Montgomery multiplication directly. Even moduli are split into (q * 2^k), where q
+	 *\n			is odd; the two partial results are then combined with the Chinese remainder theorem.
+	 *\n			The Montgomery context for the most recent odd modulus is cached, so that batches of
+	 *\n			operations with the same modulus don't have to recalculate it.
+	 * @param base	The number to raise.
+	 * @param exp	The exponent's magnitude.
+	 * @param m		The modulus. Must not be zero.
+	 * @returns		std::uint64_t
+	 */
+	inline std::uint64_t powmod(std::uint64_t const base, bigint::magnitude const& exp, std::uint64_t const m)
+	{
+		using u64 = std::uint64_t;
+		if (m == 0)
+			throw make_exception("Cannot divide by zero!");
+
+		const int k{ wideint::ctz(m) };
+		const u64 q{ m >> k };
+
+		// result modulo the odd factor
+		u64 a{ 0ull };
+		if (q != 1ull) {
+			thread_local std::optional<Montgomery> cache;
+			if (!cache.has_value() || cache->n != q)
+				cache.emplace(q);
+			a = cache->pow(base, exp);
+		}
+		if (k == 0)
+			return a;
+
+		// result modulo 2^k; 64-bit arithmetic wraps modulo 2^64, which is a multiple of 2^k
+		const u64 mask{ k == 64 ? ~0ull : (1ull << k) - 1ull };
+		u64 b{ 1ull };
+		for (size_t i{ exp.size() }; i-- > 0;) {
+			for (int bit{ 31 }; bit >= 0; --bit) {
+				b *= b;
+				if (((exp[i] >> bit) & 1u) != 0)
+					b *= base;
+			}
+		}
+		b &= mask;
+		if (q == 1ull)
+			return b;
+
+		// combine:  x = a + q * ((b - a) * q^-1 mod 2^k)
+		return a + q * (((b - a) * wideint::inverse(q)) & mask);
+	}
+
+	/**
+	 * @brief		Calculates (base ^ exp) mod m, using the same sign semantics as Calculate;
+	 *\n			the result has the sign of (base ^ exp) & the sign of the modulus is ignored.
+	 * @param base	The number to raise.
+	 * @param exp	The exponent. Must not be negative.
+	 * @param m		The modulus. Must not be zero.
+	 * @returns		bigint::integer
+	 */
+	inline bigint::integer powmod(bigint::integer const& base, bigint::integer const& exp, bigint::integer const& m)
+	{
+		if (exp.is_negative())
+			throw make_exception("Modular exponentiation doesn't support negative exponents!");
+		if (m.is_zero())
+			throw make_exception("Cannot divide by zero!");
+
+		const bool negative{ base.is_negative() && exp.is_odd() };
+		bigint::integer result;
+
+		if (m.bit_length() <= 64ull)
+			result = bigint::integer{ powmod((base.abs() % m.abs()).magnitude_ull(), exp.limbs(), m.abs().magnitude_ull()) };
+		else
+			result = bigint::powmod(base.abs(), exp, m.abs());
+
+		return negative ? -result : result;
+	}
+
+	/**
+	 * @struct	Divisor
+	 * @brief	A constant integer divisor with a precomputed magic reciprocal, so that repeated divisions by the same number
+	 *\n		only need a multiply & shift instead of a hardware division. (See "Division by Invariant Integers using Multiplication", Granlund & Montgomery)
+	 *\n		Remainders have the same semantics as Calculate<IntT>; the result has the sign of the dividend & the sign of the divisor is ignored.
+	 */
+	struct Divisor {
+		using u64 = std::uint64_t;
+
+		/// @brief	The absolute value of the divisor.
+		u64 d;
+		/// @brief	The magic number; zero when d is a power of 2.
+		u64 magic;
+		/// @brief	The final right-shift amount.
+		int shift;
+		/// @brief	When true, the magic number needs 65 bits & uses an extra add-and-halve step.
+		bool add;
+
+		Divisor(IntT const divisor) : d{ divisor < 0 ? 0ull - static_cast<u64>(divisor) : static_cast<u64>(divisor) }, magic{ 0ull }, shift{ 0 }, add{ false }
+		{
+			if (divisor == 0)
+				throw make_exception("Cannot divide by zero!");
+
+			const int log2d{ 63 - wideint::clz(d) };
+			if ((d & (d - 1ull)) == 0) { // power of 2
+				shift = log2d;
+				return;
+			}
+
+			u64 rem;
+			u64 proposed{ wideint::div({ 0ull, 1ull << log2d }, d, rem) }; // 2^(64 + log2d) / d
+			if (d - rem < (1ull << log2d)) // this power works
+				shift = log2d;
+			else { // use the 65-bit magic number (2^(65 + log2d) / d)
+				proposed += proposed;
+				const u64 twice_rem{ rem + rem };
+				if (twice_rem >= d || twice_rem < rem)
+					proposed += 1ull;
+				shift = log2d;
+				add = true;
+			}
+			magic = proposed + 1ull;
+		}
+
+		/// @brief	Returns (x / d), for an unsigned dividend.
+		u64 quotient(u64 const x) const noexcept
+		{
+			if (magic == 0ull)
+				return x >> shift;
+			const u64 q{ wideint::mulhi(magic, x) };
+			if (add)
+				return (((x - q) >> 1) + q) >> shift;
+			return q >> shift;
+		}
+
+		/// @brief	Returns (x % d), with the sign of x.
+		IntT remainder(IntT const x) const noexcept
+		{
+			const u64 ux{ x < 0 ? 0ull - static_cast<u64>(x) : static_cast<u64>(x) };
+			const u64 r{ ux - quotient(ux) * d };
+			return x < 0 ? static_cast<IntT>(0ull - r) : static_cast<IntT>(r);
+		}
+
+		/**
+		 * @brief		Calculates the remainder of each value in a block. Uses AVX2 when the CPU supports it.
+		 * @param in	Input values.
+		 * @param out	Output values. This may be the same as in.
+		 * @param count	The number of values in the block.
+		 */
+		void remainder(IntT const* in, IntT* out, size_t const count) const noexcept
+		{
+			size_t i{ 0ull };
+		#if defined(CONVLIB_DISPATCH_AVX2)
+			if (conv::has_avx2())
+				i = remainder_avx2(in, out, count);
+		#endif
+			for (; i < count; ++i)
+				out[i] = remainder(in[i]);
+		}
+
+	#if defined(CONVLIB_DISPATCH_AVX2)
+		/**
+		 * @brief		Calculates the remainders of the values in a block four at a time, with AVX2. The CPU must support it.
+		 * @param in	Input values.
+		 * @param out	Output values. This may be the same as in.
+		 * @param count	The number of values in the block.
+		 * @returns		The number of values that were calculated; the rest are left for the scalar loop.
+		 */
+		CONVLIB_TARGET_AVX2 size_t remainder_avx2(IntT const* in, IntT* out, size_t const count) const noexcept
+		{
+			size_t i{ 0ull };
+			const __m256i zero{ _mm256_setzero_si256() };
+			const __m256i lomask{ _mm256_set1_epi64x(0xFFFFFFFFll) };
+			const __m256i magic_lo{ _mm256_set1_epi64x(static_cast<long long>(magic & 0xFFFFFFFFull)) };
+			const __m256i magic_hi{ _mm256_set1_epi64x(static_cast<long long>(magic >> 32)) };
+			const __m256i d_lo{ _mm256_set1_epi64x(static_cast<long long>(d & 0xFFFFFFFFull)) };
+			const __m256i d_hi{ _mm256_set1_epi64x(static_cast<long long>(d >> 32)) };
+			const __m128i shift_count{ _mm_cvtsi32_si128(shift) };
+
+			for (; i + 4ull <= count; i += 4ull) {
+				const __m256i x{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)) };
+				// absolute value
+				const __m256i sign{ _mm256_cmpgt_epi64(zero, x) };
+				const __m256i ux{ _mm256_sub_epi64(_mm256_xor_si256(x, sign), sign) };
+
+				__m256i q;
+				if (magic == 0ull)
+					q = _mm256_srl_epi64(ux, shift_count);
+				else {
+					// high 64 bits of (ux * magic), from 32x32 => 64-bit partial products
+					const __m256i ux_hi{ _mm256_srli_epi64(ux, 32) };
+					const __m256i ll{ _mm256_mul_epu32(ux, magic_lo) };
+					const __m256i t{ _mm256_add_epi64(_mm256_mul_epu32(ux_hi, magic_lo), _mm256_srli_epi64(ll, 32)) };
+					const __m256i w{ _mm256_add_epi64(_mm256_and_si256(t, lomask), _mm256_mul_epu32(ux, magic_hi)) };
+					q = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(ux_hi, magic_hi), _mm256_srli_epi64(t, 32)), _mm256_srli_epi64(w, 32));
+					if (add)
+						q = _mm256_add_epi64(_mm256_srli_epi64(_mm256_sub_epi64(ux, q), 1), q);
+					q = _mm256_srl_epi64(q, shift_count);
+				}
+				// low 64 bits of (q * d)
+				const __m256i cross{ _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(q, 32), d_lo), _mm256_mul_epu32(q, d_hi)) };
+				const __m256i qd{ _mm256_add_epi64(_mm256_mul_epu32(q, d_lo), _mm256_slli_epi64(cross, 32)) };
+				const __m256i r{ _mm256_sub_epi64(ux, qd) };
+				// restore the sign of the dividend
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_sub_epi64(_mm256_xor_si256(r, sign), sign));
+			}
+			return i;
+		}
+	#endif
+	};
+
+	/**
+	 * @struct	Barrett
+	 * @brief	Reduces arbitrarily long digit strings modulo a fixed 64-bit modulus, one chunk of digits at a time,
+	 *\n		so the full number never has to be built.
+	 *\n		Each step reduces a 128-bit intermediate with a precomputed reciprocal of the normalized modulus
+	 *\n		(Barrett reduction, in the 2-by-1 form from "Improved division by invariant integers", Möller & Granlund),
+	 *\n		so no hardware division is needed per chunk.
+	 */
+	struct Barrett {
+		using u64 = std::uint64_t;
+
+		/// @brief	The modulus.
+		u64 m;
+		/// @brief	The number of leading zero bits in the modulus.
+		int shift;
+		/// @brief	The modulus, shifted left so that its most significant bit is set.
+		u64 d;
+		/// @brief	The reciprocal of d; floor((2^128 - 1) / d) - 2^64
+		u64 v;
+
+		Barrett(u64 const modulus) : m{ modulus }, shift{ wideint::clz(modulus) }, d{ modulus << (shift & 63) }, v{ 0ull }
+		{
+			if (modulus == 0)
+				throw make_exception("Cannot divide by zero!");
+			u64 rem;
+			v = wideint::div({ ~0ull, ~d }, d, rem);
+		}
+
+		/// @brief	Returns u mod m. The high half of u must be less than m.
+		u64 reduce(wideint::u128 u) const noexcept
+		{
+			if (shift != 0) { // normalize; the remainder is shifted by the same amount
+				u.hi = (u.hi << shift) | (u.lo >> (64 - shift));
+				u.lo <<= shift;
+			}
+			auto q{ wideint::mul(v, u.hi) };
+			const u64 lo{ q.lo + u.lo };
+			q.hi += u.hi + 1ull + (lo < q.lo ? 1ull : 0ull);
+			q.lo = lo;
+
+			u64 r{ u.lo - q.hi * d };
+			if (r > q.lo)
+				r += d;
+			if (r >= d)
+				r -= d;
+			return r >> shift;
+		}
+
+		/**
+		 * @brief		Returns the remainder of an unsigned integer string of any length.
+		 * @param s		Input digits, without any sign or radix prefix. Digit separators (',' '_' '\'') are ignored.
+		 * @param radix	The numeric base of the input, in the range [2 - 36].
+		 * @returns		u64
+		 */
+		u64 remainder(std::string_view const s, unsigned const radix = 10u) const
+		{
+			// the largest number of digits whose value always fits in 64 bits
+			u64 chunk_pow{ radix };
+			unsigned chunk_len{ 1u };
+			while (chunk_pow <= ~0ull / radix)
+				chunk_pow *= radix, ++chunk_len;
+
+			u64 r{ 0ull }, acc{ 0ull }, mul{ 1ull };
+			unsigned n{ 0u };
+			for (const char c : s) {
+				const unsigned digit{ DIGIT_VALUES[static_cast<unsigned char>(c)] };
+				if (digit >= radix) {
+					if (c == ',' || c == '_' || c == '\'')
+						continue;
+					throw make_exception("Invalid base-", radix, " digit '", c, "' in \"", s, "\"!");
+				}
+
+				acc = acc * radix + digit;
+				mul *= radix;
+				if (++n == chunk_len) { // r = (r * radix^n + acc) mod m
+					r = reduce(muladd(r, mul, acc));
+					acc = 0ull, mul = 1ull, n = 0u;
+				}
+			}
+			if (n != 0u)
+				r = reduce(muladd(r, mul, acc));
+			return r;
+		}
+
+	private:
+		/// @brief	Lookup table of the value of each alphanumeric digit character; all other characters are 0xFF.
+		static constexpr auto DIGIT_VALUES{ []() {
+			std::array<unsigned char, 256> table{};
+			table.fill(0xFF);
+			for (int c{ '0' }; c <= '9'; ++c) table[c] = static_cast<unsigned char>(c - '0');
+			for (int c{ 'a' }; c <= 'z'; ++c) table[c] = static_cast<unsigned char>(c - 'a' + 10);
+			for (int c{ 'A' }; c <= 'Z'; ++c) table[c] = static_cast<unsigned char>(c - 'A' + 10);
+			return table;
+		}() };
+
+		/// @brief	Returns (a * b + c) as a 128-bit value. Since a < m, the high half is also less than m.
+		static wideint::u128 muladd(u64 const a, u64 const b, u64 const c) noexcept
+		{
+			auto p{ wideint::mul(a, b) };
+			p.lo += c;
+			if (p.lo < c)
+				++p.hi;
+			return p;
+		}
+	};
+
+	/**
+	 * @brief		Detects the numeric base of an integer string, using the same rules as hexadecimal mode:
+	 *\n			The input is hexadecimal when it is prefixed with "0x" or contains at least one letter in the range [A - F].
+	 * @param s		Input string, optionally with a leading sign.
+	 * @returns		16 for hexadecimal, otherwise 10.
+	 */
+	inline unsigned detect_radix(std::string_view s) noexcept
+	{
+		if (!s.empty() && (s.front() == '-' || s.front() == '+'))
+			s.remove_prefix(1);
+		if (s.size() > 2ull && s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+			return 16u;
+		return s.find_first_of("abcdefABCDEF") != std::string_view::npos ? 16u : 10u;
+	}
+
+	/**
+	 * @brief			Calculates the remainder of an integer string of any length, using the same sign semantics as Calculate.
+	 * @param number	Input integer string, with an optional sign & optional "0x" prefix.
+	 * @param reducer	The precomputed reducer for the absolute value of the divisor.
+	 * @param radix		The numeric base of the input.
+	 * @returns			IntT
+	 */
+	inline IntT remainder(std::string_view number, Barrett const& reducer, unsigned const radix)
+	{
+		bool negative{ false };
+		if (!number.empty() && (number.front() == '-' || number.front() == '+'))
+			negative = number.front() == '-', number.remove_prefix(1);
+		if (radix == 16u && number.size() > 2ull && number[0] == '0' && (number[1] == 'x' || number[1] == 'X'))
+			number.remove_prefix(2);
+		if (number.empty())
+			throw make_exception("Invalid number: no digits were specified!");
+
+		const auto r{ reducer.remainder(number, radix) };
+		return negative ? static_cast<IntT>(0ull - r) : static_cast<IntT>(r);
+	}
+}
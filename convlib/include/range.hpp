@@ -0,0 +1,76 @@
+/**
+ * @file	range.hpp
+ * @author	radj307
+ * @brief	Arithmetic sequences written as "start:stop[:step]", for modes that generate their own input values.
+ */
+#pragma once
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <string_view>
+
+namespace conv {
+	/**
+	 * @struct	range
+	 * @brief	An inclusive arithmetic sequence of values from start to stop.
+	 * @tparam	T	Floating-point value type.
+	 */
+	template<std::floating_point T = long double>
+	struct range {
+		T start, stop, step;
+
+		/// @brief	Returns the number of values in the sequence, or 0 when it is empty or has too many values to count.
+		size_t size() const noexcept
+		{
+			// allow for rounding error so that stop is included when it is a multiple of step away from start
+			const T last{ std::floor((stop - start) / step + static_cast<T>(1e-9)) };
+			return last >= 0 && last < static_cast<T>(std::numeric_limits<size_t>::max()) ? static_cast<size_t>(last) + 1ull : 0ull;
+		}
+
+		/// @brief	Returns the value at the given index. Values are computed directly from start rather than accumulated, so errors don't compound.
+		T operator[](size_t const i) const noexcept
+		{
+			return start + step * static_cast<T>(i);
+		}
+	};
+
+	/**
+	 * @brief		Parses a range specifier in the format "start:stop[:step]". When step is omitted, it defaults to 1.
+	 * @param s		Input string.
+	 * @returns		range<T>
+	 */
+	template<std::floating_point T = long double>
+	inline range<T> parse_range(std::string_view const s)
+	{
+		T values[3]{ 0, 0, 1 };
+		size_t count{ 0ull };
+		bool valid{ true };
+		for (size_t pos{ 0ull }; valid; pos = s.find(':', pos) + 1ull) {
+			if (count == 3ull) { // too many values
+				valid = false;
+				break;
+			}
+			const size_t end{ std::min(s.find(':', pos), s.size()) };
+			const char* const first{ s.data() + pos + (pos < end && s[pos] == '+') }; // from_chars doesn't accept a leading plus sign
+			const auto [ptr, ec] { std::from_chars(first, s.data() + end, values[count++]) };
+			valid = ec == std::errc{} && ptr == s.data() + end;
+			if (end == s.size())
+				break;
+		}
+		if (!valid || count < 2ull)
+			throw make_exception("Invalid range \"", s, "\"; expected the format \"start:stop[:step]\"!");
+
+		const range<T> r{ values[0], values[1], values[2] };
+		if (!std::isfinite(r.start) || !std::isfinite(r.stop) || !std::isfinite(r.step))
+			throw make_exception("Invalid range \"", s, "\"; start, stop, & step must be finite!");
+		if (r.step == 0 || (r.stop - r.start) / r.step < 0)
+			throw make_exception("Invalid range \"", s, "\"; the step must move from start towards stop!");
+		if (r.size() == 0ull)
+			throw make_exception("Invalid range \"", s, "\"; it has too many values!");
+		return r;
+	}
+}
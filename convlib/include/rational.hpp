@@ -0,0 +1,296 @@
+/**
+ * @file	rational.hpp
+ * @author	radj307
+ * @brief	Exact fractions of 128-bit integers, & exact multiplication of decimal numbers by them.
+ *\n		Only available when the compiler provides unsigned __int128.
+ */
+#pragma once
+#include "format.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__SIZEOF_INT128__)
+namespace conv {
+	using uint128 = unsigned __int128;
+
+	namespace detail {
+		inline constexpr uint128 UINT128_MAX{ ~uint128{ 0 } };
+
+		inline constexpr uint128 gcd(uint128 a, uint128 b) noexcept
+		{
+			while (b != 0) {
+				const uint128 r{ a % b };
+				a = b;
+				b = r;
+			}
+			return a;
+		}
+		/// @brief	Multiplies two numbers, or returns false when the product doesn't fit in 128 bits.
+		inline constexpr bool mul(uint128 const a, uint128 const b, uint128& product) noexcept
+		{
+			if (a != 0 && b > UINT128_MAX / a)
+				return false;
+			product = a * b;
+			return true;
+		}
+		/// @brief	Returns 10 to the power of exponent, which must be in the range [0 - 38].
+		inline constexpr uint128 pow10(int const exponent) noexcept
+		{
+			uint128 result{ 1 };
+			for (int i{ 0 }; i < exponent; ++i)
+				result *= 10;
+			return result;
+		}
+	}
+
+	/**
+	 * @struct	rational
+	 * @brief	A non-negative fraction in lowest terms. Operations whose result doesn't fit return an invalid fraction, which has a zero denominator.
+	 */
+	struct rational {
+		uint128 num{ 0 }, den{ 1 };
+
+		constexpr bool valid() const noexcept { return den != 0; }
+
+		/// @brief	Returns the fraction n/d in lowest terms.
+		static constexpr rational of(uint128 const n, uint128 const d) noexcept
+		{
+			if (d == 0)
+				return{ 0, 0 };
+			const uint128 g{ detail::gcd(n, d) };
+			return{ n / g, d / g };
+		}
+		/// @brief	Returns 10 to the power of exponent, which must be in the range [-38 - 38].
+		static constexpr rational pow10(int const exponent) noexcept
+		{
+			return exponent < 0 ? rational{ 1, detail::pow10(-exponent) } : rational{ detail::pow10(exponent), 1 };
+		}
+
+		friend constexpr rational operator*(rational const& l, rational const& r) noexcept
+		{
+			if (!l.valid() || !r.valid())
+				return{ 0, 0 };
+			// both operands are already reduced, so cancelling across them is enough to reduce the product
+			const uint128 g1{ detail::gcd(l.num, r.den) }, g2{ detail::gcd(r.num, l.den) };
+			rational result;
+			if (!detail::mul(l.num / g1, r.num / g2, result.num) || !detail::mul(l.den / g2, r.den / g1, result.den))
+				return{ 0, 0 };
+			return result;
+		}
+		friend constexpr rational operator/(rational const& l, rational const& r) noexcept
+		{
+			return r.num == 0 ? rational{ 0, 0 } : l * rational{ r.den, r.num };
+		}
+	};
+
+	/**
+	 * @struct	decimal
+	 * @brief	A decimal number stored exactly, as mantissa / 10^scale.
+	 */
+	struct decimal {
+		uint128 mantissa{ 0 };
+		int scale{ 0 };
+		bool negative{ false };
+	};
+
+	/**
+	 * @brief			Parses a decimal number without rounding, ex: "-12.375", "1,760", "6.02e23". Commas in the integer part are ignored.
+	 * @param first		The start of the input.
+	 * @param last		The end of the input.
+	 * @param value		Receives the number.
+	 * @returns			A std::from_chars_result, where ec is std::errc::invalid_argument when the input doesn't start with a number, or
+	 *\n				 std::errc::result_out_of_range when it has more than 38 digits or a scale of more than 10^38.
+	 */
+	inline constexpr std::from_chars_result parse_decimal(const char* first, const char* const last, decimal& value) noexcept
+	{
+		const char* const begin{ first };
+		decimal result;
+		if (first != last && (*first == '-' || *first == '+'))
+			result.negative = *first++ == '-';
+
+		bool hasDigits{ false };
+		const auto& append_digit{ [&result](char const c) {
+			return detail::mul(result.mantissa, 10, result.mantissa) && (result.mantissa += static_cast<unsigned>(c - '0')) >= static_cast<unsigned>(c - '0');
+		} };
+		for (; first != last && ((*first >= '0' && *first <= '9') || (*first == ',' && hasDigits)); ++first) {
+			if (*first == ',')
+				continue;
+			if (!append_digit(*first))
+				return{ first, std::errc::result_out_of_range };
+			hasDigits = true;
+		}
+		if (first != last && *first == '.') {
+			for (++first; first != last && *first >= '0' && *first <= '9'; ++first, ++result.scale) {
+				if (!append_digit(*first))
+					return{ first, std::errc::result_out_of_range };
+				hasDigits = true;
+			}
+		}
+		if (!hasDigits)
+			return{ begin, std::errc::invalid_argument };
+
+		// the exponent is only consumed when it has digits
+		if (last - first >= 2 && (*first == 'e' || *first == 'E')) {
+			const char* p{ first + 1 };
+			const bool negativeExponent{ *p == '-' };
+			if (*p == '-' || *p == '+')
+				++p;
+			if (p != last && *p >= '0' && *p <= '9') {
+				int exponent{ 0 };
+				for (; p != last && *p >= '0' && *p <= '9'; ++p)
+					if ((exponent = exponent * 10 + (*p - '0')) > 1000)
+						return{ p, std::errc::result_out_of_range };
+				result.scale += negativeExponent ? exponent : -exponent;
+				first = p;
+			}
+		}
+		if (result.scale < 0) {
+			if (result.scale < -38 || !detail::mul(result.mantissa, detail::pow10(-result.scale), result.mantissa))
+				return{ first, std::errc::result_out_of_range };
+			result.scale = 0;
+		}
+		else if (result.scale > 38)
+			return{ first, std::errc::result_out_of_range };
+
+		value = result;
+		return{ first, std::errc{} };
+	}
+
+	/**
+	 * @brief			Multiplies a decimal number by a fraction, & writes the exact result rounded once, to the nearest (ties to even).
+	 *\n				Fixed notation writes exactly fmt.precision digits after the decimal point. Otherwise, fractions are rounded to
+	 *\n				 fmt.precision significant digits & trailing zeros are removed, except that the shortest representation is every
+	 *\n				 digit of the exact result, up to 40 decimal places. Integer digits are never rounded, & exponents are never used.
+	 * @param first		Output buffer.
+	 * @param last		The end of the output buffer. 128 characters are always enough.
+	 * @param value		The decimal number.
+	 * @param factor	The fraction to multiply it by.
+	 * @param fmt		The output format.
+	 * @returns			A std::to_chars_result, where ec is std::errc::result_out_of_range when the result or an intermediate value
+	 *\n				 doesn't fit in 128 bits, or std::errc::value_too_large when the buffer is too small.
+	 */
+	inline std::to_chars_result format(char* first, char* last, decimal const& value, rational const& factor, FloatFormat const& fmt) noexcept
+	{
+		constexpr int MAX_PLACES{ 40 };
+		// a result of at least 1/2^124 has at most 38 zeros after the decimal point
+		constexpr int MAX_LEADING_ZEROS{ 38 };
+		if (last - first < 2 + 39 + MAX_LEADING_ZEROS + MAX_PLACES)
+			return{ last, std::errc::value_too_large };
+		if (!factor.valid())
+			return{ first, std::errc::result_out_of_range };
+
+		// value * factor = (mantissa * num) / (10^scale * den); common factors are cancelled first so that both halves stay small
+		uint128 n{ value.mantissa }, p{ factor.num }, t{ detail::pow10(value.scale) }, d{ factor.den };
+		if (const uint128 g{ detail::gcd(n, d) }; g > 1) {
+			n /= g;
+			d /= g;
+		}
+		if (const uint128 g{ detail::gcd(p, t) }; g > 1) {
+			p /= g;
+			t /= g;
+		}
+		// the denominator is kept below 2^124, so that the remainder can be multiplied by 10 without overflowing
+		uint128 denominator;
+		if (!detail::mul(t, d, denominator) || denominator >= (uint128{ 1 } << 124))
+			return{ first, std::errc::result_out_of_range };
+
+		// the integer part & remainder of n * p / denominator
+		uint128 whole, remainder;
+		if (uint128 product; detail::mul(n, p, product)) {
+			whole = product / denominator;
+			remainder = product % denominator;
+		}
+		else {
+			// p = a * denominator + b, so n * p / denominator = n * a + n * b / denominator
+			const uint128 a{ p / denominator }, b{ p % denominator };
+			if (!detail::mul(n, a, whole))
+				return{ first, std::errc::result_out_of_range };
+			// n * b / denominator, one bit of n at a time; the remainder never reaches 2 * denominator, so it can't overflow
+			uint128 quotient{ 0 };
+			remainder = 0;
+			for (int bit{ 127 }; bit >= 0; --bit) {
+				quotient <<= 1;
+				remainder <<= 1;
+				if (remainder >= denominator) {
+					remainder -= denominator;
+					++quotient;
+				}
+				if (((n >> bit) & 1) != 0) {
+					remainder += b;
+					if (remainder >= denominator) {
+						remainder -= denominator;
+						++quotient;
+					}
+				}
+			}
+			if (whole > detail::UINT128_MAX - quotient)
+				return{ first, std::errc::result_out_of_range };
+			whole += quotient;
+		}
+
+		// the integer digits
+		char integer[39];
+		int integerCount{ 0 };
+		for (uint128 w{ whole }; w != 0 || integerCount == 0; w /= 10)
+			integer[integerCount++] = static_cast<char>('0' + static_cast<int>(w % 10));
+
+		// the digits after the decimal point
+		const int precision{ fmt.precision < 0 ? 6 : (fmt.precision > MAX_PLACES ? MAX_PLACES : fmt.precision) };
+		const bool fixed{ fmt.notation == FloatFormat::Notation::Fixed && !fmt.shortest };
+		const bool general{ !fixed && !fmt.shortest };
+		const int significant{ precision == 0 ? 1 : precision }; //< as with printf's "%g"
+		int places{ fixed ? precision : (general ? (whole != 0 ? (significant > integerCount ? significant - integerCount : 0) : MAX_LEADING_ZEROS + significant) : MAX_PLACES) };
+		char digits[MAX_LEADING_ZEROS + MAX_PLACES];
+		int count{ 0 };
+		for (bool leading{ general && whole == 0 }; count < places && remainder != 0;) {
+			remainder *= 10;
+			const int digit{ static_cast<int>(remainder / denominator) };
+			remainder %= denominator;
+			digits[count++] = static_cast<char>('0' + digit);
+			if (leading && digit != 0) { // the first significant digit
+				leading = false;
+				places = count - 1 + significant;
+			}
+		}
+
+		// round to nearest, ties to even
+		const int lastDigit{ count != 0 ? digits[count - 1] - '0' : integer[0] - '0' };
+		if (remainder != 0 && (remainder * 2 > denominator || (remainder * 2 == denominator && lastDigit % 2 != 0))) {
+			int i{ count - 1 };
+			for (; i >= 0 && digits[i] == '9'; --i)
+				digits[i] = '0';
+			if (i >= 0)
+				++digits[i];
+			else {
+				int j{ 0 };
+				for (; j < integerCount && integer[j] == '9'; ++j)
+					integer[j] = '0';
+				if (j < integerCount)
+					++integer[j];
+				else if (integerCount < static_cast<int>(sizeof(integer)))
+					integer[integerCount++] = '1';
+				else return{ first, std::errc::result_out_of_range };
+			}
+		}
+		if (fixed)
+			while (count < places)
+				digits[count++] = '0';
+		else while (count != 0 && digits[count - 1] == '0')
+			--count;
+
+		char* out{ first };
+		if (value.negative && !(integerCount == 1 && integer[0] == '0' && count == 0))
+			*out++ = '-';
+		for (int i{ integerCount - 1 }; i >= 0; --i)
+			*out++ = integer[i];
+		if (count != 0) {
+			*out++ = '.';
+			for (int i{ 0 }; i < count; ++i)
+				*out++ = digits[i];
+		}
+		return{ out, std::errc{} };
+	}
+}
+#endif
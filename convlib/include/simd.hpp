@@ -0,0 +1,48 @@
+/**
+ * @file	simd.hpp
+ * @author	radj307
+ * @brief	Runtime CPU feature detection for the batch kernels, so that builds for baseline x86-64 can still use AVX2.
+ *\n		Kernels are compiled with CONVLIB_TARGET_AVX2 when CONVLIB_DISPATCH_AVX2 is defined, & only called when has_avx2() is true.
+ */
+#pragma once
+
+// the batch kernels check for AVX2 at runtime, so x86-64 builds always include it
+#if defined(__x86_64__) || defined(_M_X64)
+#define CONVLIB_DISPATCH_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CONVLIB_TARGET_AVX2
+#else
+#define CONVLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace conv {
+#if defined(CONVLIB_DISPATCH_AVX2)
+	/// @brief	Returns true when the CPU & operating system support AVX2 instructions.
+	inline bool has_avx2() noexcept
+	{
+	#if defined(__AVX2__)
+		return true;
+	#elif defined(_MSC_VER) && !defined(__clang__)
+		static const bool supported{ []() {
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+			__cpuid(info, 1);
+			// OSXSAVE & AVX, & the OS saves the YMM registers
+			if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6ull) != 6ull)
+				return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}() };
+		return supported;
+	#else
+		static const bool supported{ __builtin_cpu_supports("avx2") != 0 };
+		return supported;
+	#endif
+	}
+#endif
+}
@@ -1,10 +1,20 @@
 #pragma once
 
+#include "affine.hpp"
+
 #include <make_exception.hpp>
 #include <str.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <optional>
 #include <ostream>
+#include <string_view>
+#include <vector>
 
 namespace conv {
 	enum class TemperatureSystem : std::int8_t {
@@ -18,56 +28,176 @@ namespace conv {
 		return l == static_cast<TemperatureSystem>(r);
 	}
 
+	/**
+	 * @struct	fixed_affine
+	 * @brief	Exact integer version of an affine transform ((scale * x + offset) / divisor), used for integral temperature values.
+	 *\n		Every conversion between temperature systems is a ratio of small integers, so results are rounded to the nearest integer
+	 *\n		 exactly once; none of them land exactly halfway between two integers.
+	 */
+	struct fixed_affine {
+		std::int64_t scale, offset, divisor;
+
+		/// @brief	Returns the transform that applies this one, followed by the given one.
+		constexpr fixed_affine then(fixed_affine const& next) const noexcept
+		{
+			return{ next.scale * scale, next.scale * offset + next.offset * divisor, next.divisor * divisor };
+		}
+
+		template<std::integral T>
+		constexpr T operator()(T const value) const noexcept
+		{
+			// split value into quotient * divisor + remainder, with 0 <= remainder < divisor; the quotient is scaled exactly, & the
+			//  remainder's share is small enough that nothing overflows unless the result itself does
+			const std::int64_t v{ static_cast<std::int64_t>(value) };
+			std::int64_t quotient{ v / divisor }, remainder{ v % divisor };
+			if (remainder < 0) {
+				--quotient;
+				remainder += divisor;
+			}
+			// round (scale * remainder + offset) / divisor to the nearest integer, using floor division
+			const std::int64_t twice{ 2 * (scale * remainder + offset) + divisor };
+			std::int64_t fraction{ twice / (2 * divisor) };
+			if (twice % (2 * divisor) < 0)
+				--fraction;
+			return static_cast<T>(quotient * scale + fraction);
+		}
+	};
+
+	namespace detail {
+		// @brief	Transforms from each temperature system to Celcius, in the same order as TemperatureSystem.
+		inline constexpr affine TO_CELCIUS[3]{
+			{ 1.0L, -273.15L },				// Kelvin
+			{ 1.0L, 0.0L },					// Celcius
+			{ 1.0L / 1.8L, -32.0L / 1.8L },	// Fahrenheit
+		};
+		// @brief	Transforms from Celcius to each temperature system, in the same order as TemperatureSystem.
+		inline constexpr affine FROM_CELCIUS[3]{
+			{ 1.0L, 273.15L },				// Kelvin
+			{ 1.0L, 0.0L },					// Celcius
+			{ 1.8L, 32.0L },				// Fahrenheit
+		};
+		// @brief	TO_CELCIUS as exact ratios; offsets are in hundredths of a degree.
+		inline constexpr fixed_affine FIXED_TO_CELCIUS[3]{
+			{ 100, -27315, 100 },			// Kelvin
+			{ 1, 0, 1 },					// Celcius
+			{ 5, -160, 9 },					// Fahrenheit
+		};
+		// @brief	FROM_CELCIUS as exact ratios; offsets are in hundredths of a degree.
+		inline constexpr fixed_affine FIXED_FROM_CELCIUS[3]{
+			{ 100, 27315, 100 },			// Kelvin
+			{ 1, 0, 1 },					// Celcius
+			{ 9, 160, 5 },					// Fahrenheit
+		};
+
+		inline constexpr size_t index(TemperatureSystem const system) noexcept
+		{
+			return static_cast<size_t>(static_cast<std::int8_t>(system) - 1);
+		}
+		inline constexpr bool is_valid(TemperatureSystem const system) noexcept
+		{
+			return index(system) < 3ull;
+		}
+	}
+
+	/// @brief	Precomputed conversion transforms for every pair of temperature systems, indexed by [input - 1][output - 1].
+	inline constexpr auto TRANSFORMS{ []() {
+		std::array<std::array<affine, 3>, 3> table{};
+		for (size_t in{ 0ull }; in < 3ull; ++in)
+			for (size_t out{ 0ull }; out < 3ull; ++out)
+				table[in][out] = (in == out) ? affine{ 1.0L, 0.0L } : detail::TO_CELCIUS[in].then(detail::FROM_CELCIUS[out]);
+		return table;
+	}() };
+
+	/// @brief	Exact integer versions of TRANSFORMS, for integral temperature values.
+	inline constexpr auto FIXED_TRANSFORMS{ []() {
+		std::array<std::array<fixed_affine, 3>, 3> table{};
+		for (size_t in{ 0ull }; in < 3ull; ++in)
+			for (size_t out{ 0ull }; out < 3ull; ++out)
+				table[in][out] = (in == out) ? fixed_affine{ 1, 0, 1 } : detail::FIXED_TO_CELCIUS[in].then(detail::FIXED_FROM_CELCIUS[out]);
+		return table;
+	}() };
+
+	/**
+	 * @brief				Gets the transform that converts between two temperature systems.
+	 * @param inputSystem	The temperature system to convert from.
+	 * @param outputSystem	The temperature system to convert to.
+	 * @returns				affine
+	 */
+	inline affine const& getTransform(TemperatureSystem const inputSystem, TemperatureSystem const outputSystem)
+	{
+		if (!detail::is_valid(outputSystem))
+			throw make_exception("Invalid output temperature system: '", static_cast<int>(outputSystem), "'");
+		if (!detail::is_valid(inputSystem))
+			throw make_exception("Invalid input temperature system: '", static_cast<int>(inputSystem), "'");
+		return TRANSFORMS[detail::index(inputSystem)][detail::index(outputSystem)];
+	}
+
+	/**
+	 * @brief				Converts a temperature value from one system to another.
+	 *\n					Integral values are converted exactly & rounded to the nearest integer once, using FIXED_TRANSFORMS.
+	 *\n					 Previously, they were truncated after each step through Celcius instead; the convert* helpers below still truncate.
+	 * @param inputSystem	The temperature system to convert from.
+	 * @param value			The value to convert.
+	 * @param outputSystem	The temperature system to convert to.
+	 * @returns				The converted value.
+	 */
+	template<typename T> requires std::floating_point<T> || std::integral<T>
+	T convert(TemperatureSystem const inputSystem, T const value, TemperatureSystem const outputSystem)
+	{
+		const auto& transform{ getTransform(inputSystem, outputSystem) };
+		if constexpr (std::floating_point<T>)
+			return transform(value);
+		else
+			return FIXED_TRANSFORMS[detail::index(inputSystem)][detail::index(outputSystem)](value);
+	}
+
+	/**
+	 * @brief				Converts a block of temperature values from one system to another.
+	 * @param inputSystem	The temperature system to convert from.
+	 * @param in			Input values.
+	 * @param out			Output values. This may be the same as in.
+	 * @param count			The number of values to convert.
+	 * @param outputSystem	The temperature system to convert to.
+	 */
+	template<typename T> requires std::floating_point<T> || std::integral<T>
+	void convert(TemperatureSystem const inputSystem, T const* in, T* out, size_t const count, TemperatureSystem const outputSystem)
+	{
+		if constexpr (std::integral<T>) {
+			const auto& fixed{ FIXED_TRANSFORMS[detail::index(inputSystem)][detail::index(outputSystem)] };
+			for (size_t i{ 0ull }; i < count; ++i)
+				out[i] = fixed(in[i]);
+		}
+		else transform(getTransform(inputSystem, outputSystem), in, out, count);
+	}
+
+	namespace detail {
+		/// @brief	Applies one of TRANSFORMS in long double, & casts the result back to T; integral results are truncated.
+		template<typename T>
+		T convert_truncated(TemperatureSystem const inputSystem, T const value, TemperatureSystem const outputSystem)
+		{
+			return static_cast<T>(TRANSFORMS[index(inputSystem)][index(outputSystem)](static_cast<long double>(value)));
+		}
+	}
+
 	template<typename T>
 	T convertFahrenheitToCelcius(T const value)
 	{
-		return static_cast<T>((static_cast<long double>(value) - 32.0L) / 1.8L);
+		return detail::convert_truncated(TemperatureSystem::Fahrenheit, value, TemperatureSystem::Celcius);
 	}
 	template<typename T>
 	T convertCelciusToFahrenheit(T const value)
-	{//                                                         ▼▼▼▼ == (9 / 5)
-		return static_cast<T>(static_cast<long double>(value) * 1.8L + 32.0L);
+	{
+		return detail::convert_truncated(TemperatureSystem::Celcius, value, TemperatureSystem::Fahrenheit);
 	}
 	template<typename T>
 	T convertCelciusToKelvin(T const value)
 	{
-		return static_cast<T>(static_cast<long double>(value) + 273.15L);
+		return detail::convert_truncated(TemperatureSystem::Celcius, value, TemperatureSystem::Kelvin);
 	}
 	template<typename T>
 	T convertKelvinToCelcius(T const value)
 	{
-		return static_cast<T>(static_cast<long double>(value) - 273.15L);
-	}
-
-	template<typename T>
-	T convert(TemperatureSystem const inputSystem, T const value, TemperatureSystem const outputSystem)
-	{
-		switch (outputSystem) {
-		case TemperatureSystem::Kelvin:
-			switch (inputSystem) {
-			case TemperatureSystem::Kelvin: return value;
-			case TemperatureSystem::Celcius: return convertCelciusToKelvin(value);
-			case TemperatureSystem::Fahrenheit: return convertCelciusToKelvin(convertFahrenheitToCelcius(value));
-			}
-			break;
-		case TemperatureSystem::Celcius:
-			switch (inputSystem) {
-			case TemperatureSystem::Kelvin: return convertKelvinToCelcius(value);
-			case TemperatureSystem::Celcius: return value;
-			case TemperatureSystem::Fahrenheit: return convertFahrenheitToCelcius(value);
-			}
-			break;
-		case TemperatureSystem::Fahrenheit:
-			switch (inputSystem) {
-			case TemperatureSystem::Kelvin: return convertCelciusToFahrenheit(convertKelvinToCelcius(value));
-			case TemperatureSystem::Celcius: return convertCelciusToFahrenheit(value);
-			case TemperatureSystem::Fahrenheit: return value;
-			}
-			break;
-		default:
-			throw make_exception("Invalid output temperature system: '", static_cast<std::int8_t>(outputSystem), "'");
-		}
-		throw make_exception("Invalid input temperature system: '", static_cast<std::int8_t>(inputSystem), "'");
+		return detail::convert_truncated(TemperatureSystem::Kelvin, value, TemperatureSystem::Celcius);
 	}
 
 	template<typename T>
@@ -105,7 +235,7 @@ namespace conv {
 	 * @param system	Input Temperature System.
 	 * @returns			A string representing the given TemperatureSystem.
 	 */
-	inline std::string getTemperatureSystemSymbol(const TemperatureSystem system)
+	inline constexpr std::string_view getTemperatureSystemSymbol(const TemperatureSystem system)
 	{
 		switch (system) {
 		case TemperatureSystem::Kelvin:
@@ -130,82 +260,136 @@ namespace conv {
 		}
 	};
 
-	std::vector<std::string> temperature_preprocess_arguments(std::vector<std::string> const& arguments)
-	{
-		std::vector<std::string> vec;
-		vec.reserve(arguments.size());
-
-		for (const auto& it : arguments) {
-			if (const auto& fstAlpha{ std::find_if(it.begin(), it.end(), [](auto&& ch) { return std::isalpha(ch); }) };
-				fstAlpha != it.end()) {
-				if (const auto& fstDigit{ std::find_if(it.begin(), it.end(), [](auto&& ch) { return std::isdigit(ch); }) };
-					fstDigit != it.end()) {
-					const auto& fstAlphaIndex{ std::distance(it.begin(), fstAlpha) };
-					if (fstAlpha > fstDigit) { // input value precedes input unit
-						vec.emplace_back(str::trim(it.substr(fstAlphaIndex)).substr(0ull, 1ull)); //< push input unit
-						vec.emplace_back(str::trim(it.substr(0ull, fstAlphaIndex))); //< push input value
-						continue;
-					}
-					else { // input unit precedes input value
-						vec.emplace_back(str::trim(it.substr(0ull, fstAlphaIndex)).substr(0ull, 1ull)); //< push input unit
-						vec.emplace_back(str::trim(it.substr(fstAlphaIndex))); //< push input value
-						continue;
-					}
-				}
+	/**
+	 * @class	TemperatureScanner
+	 * @brief	Incremental parser that turns a stream of whitespace-delimited tokens into TempConversion records.
+	 *\n		Input temperatures may be written as one token ("100C", "C100", "-40°F") or two tokens in either order ("100 C", "C -40").
+	 *\n		Each input temperature is followed by the output temperature system. Tokens are never copied, so memory use is constant.
+	 * @tparam	T	The numeric type of temperature values.
+	 */
+	template<typename T> requires std::floating_point<T> || std::integral<T>
+	class TemperatureScanner {
+		std::optional<TemperatureSystem> inputSystem{ std::nullopt };
+		std::optional<T> inputValue{ std::nullopt };
+
+		static bool is_number_start(std::string_view const s, size_t const pos) noexcept
+		{
+			const auto is_digit{ [&s](size_t const i) { return i < s.size() && std::isdigit(static_cast<unsigned char>(s[i])); } };
+			switch (s[pos]) {
+			case '-': case '+':
+				return is_digit(pos + 1ull) || (pos + 1ull < s.size() && s[pos + 1ull] == '.' && is_digit(pos + 2ull));
+			case '.':
+				return is_digit(pos + 1ull);
+			default:
+				return is_digit(pos);
 			}
-			vec.emplace_back(it);
 		}
 
-		return vec;
-	}
-
-	template<typename T> requires std::floating_point<T> || std::integral<T>
-	std::vector<TempConversion<T>> temperature_parse_arguments(std::vector<std::string> arguments)
-	{
-		arguments = temperature_preprocess_arguments(arguments);
-
-		std::vector<TempConversion<T>> vec;
-		vec.reserve(arguments.size() / 2);
+		static TemperatureSystem parse_system(std::string_view const token, char const ch)
+		{
+			if (const auto sys{ getTemperatureSystem(static_cast<char>(std::toupper(static_cast<unsigned char>(ch)))) }; sys != 0)
+				return sys;
+			throw make_exception("'", token, "' is not a valid temperature system!\n(Expected 'K' (Kelvin), 'C' (Celcius), or 'F' (Fahrenheit))");
+		}
 
-		std::optional<temperature<T>> input_temp{ std::nullopt };
+		/**
+		 * @brief			Parses the number at the beginning of the given string.
+		 * @param s			Input string, beginning with a number.
+		 * @param token		The whole token, for error messages.
+		 * @param value		Receives the parsed value.
+		 * @returns			The number of characters that were consumed.
+		 */
+		static size_t parse_value(std::string_view s, std::string_view const token, T& value)
+		{
+			size_t skip{ 0ull };
+			if (s.front() == '+') // from_chars doesn't accept a leading plus sign
+				s.remove_prefix(skip = 1ull);
+			const auto [ptr, ec] { std::from_chars(s.data(), s.data() + s.size(), value) };
+			if (ec != std::errc{})
+				throw make_exception("'", token, "' is not a valid number!");
+			return skip + static_cast<size_t>(ptr - s.data());
+		}
 
-		for (auto it{ arguments.begin() }; it != arguments.end(); ++it) {
-			if (!input_temp.has_value()) {
-				if (str::isnumber(*it)) { // reorder elements
-					const auto value_copy{ *it };
-					auto next{ it + 1 };
-					*it = *next;
-					*next = value_copy;
-				}
+		void set_system(std::string_view const token, char const ch)
+		{
+			if (inputSystem.has_value())
+				throw make_exception("'", token, "' is not a valid number!");
+			inputSystem = parse_system(token, ch);
+		}
 
-				const auto sys{ getTemperatureSystem(it->at(0ull)) };
-				if (sys == 0) // ERROR ; Expected a valid temperature system
-					throw make_exception("'", *it, "' is not a valid temperature system!\n(Expected 'K' (Kelvin), 'C' (Celcius), or 'F' (Fahrenheit))");
-				// increment iterator to next element
-				if (++it == arguments.end())
-					break;
-				if (!str::isnumber(*it)) // ERROR ; Expected input value
-					throw make_exception("'", *it, "' is not a valid number!");
+	public:
+		/**
+		 * @brief			Consumes the next input token.
+		 * @param token		A single whitespace-delimited token.
+		 * @param emit		A function that accepts a TempConversion<T>, which is called each time a conversion is completed.
+		 */
+		template<typename TFunc>
+		void feed(std::string_view const token, TFunc&& emit)
+		{
+			if (token.empty())
+				return;
 
-				const T val{ str::tonumber<T>(*it) };
+			// the input temperature is complete; this token is the output system
+			if (inputSystem.has_value() && inputValue.has_value()) {
+				const auto alpha{ std::find_if(token.begin(), token.end(), [](auto&& ch) { return std::isalpha(static_cast<unsigned char>(ch)); }) };
+				emit(TempConversion<T>{ temperature<T>{ inputSystem.value(), inputValue.value() }, parse_system(token, alpha == token.end() ? token.front() : *alpha) });
+				inputSystem = std::nullopt;
+				inputValue = std::nullopt;
+				return;
+			}
 
-				if (sys == TemperatureSystem::Kelvin && val < 0.0f) // ERROR ; Kelvin temps cannot be negative
-					throw make_exception("'", *it, "' is not a valid Kelvin temperature value because it is negative! (0 Kelvin == Absolute Zero)");
+			// find where the number (if any) begins, & the first letter outside of it
+			size_t numPos{ 0ull };
+			while (numPos < token.size() && !is_number_start(token, numPos))
+				++numPos;
 
-				input_temp = temperature<T>{ sys, val };
+			if (numPos == 0ull) { // value precedes unit
+				T value;
+				const size_t end{ parse_value(token, token, value) };
+				if (inputValue.has_value())
+					throw make_exception("Expected a temperature system instead of '", token, "'!");
+				inputValue = value;
+				if (const auto alpha{ std::find_if(token.begin() + end, token.end(), [](auto&& ch) { return std::isalpha(static_cast<unsigned char>(ch)); }) }; alpha != token.end())
+					set_system(token, *alpha);
+				else if (std::any_of(token.begin() + end, token.end(), [](auto&& ch) { return std::isdigit(static_cast<unsigned char>(ch)) || ch == '.'; }))
+					throw make_exception("'", token, "' is not a valid number!");
+			}
+			else { // unit precedes value, or there is no value
+				const auto alpha{ std::find_if(token.begin(), token.begin() + numPos, [](auto&& ch) { return std::isalpha(static_cast<unsigned char>(ch)); }) };
+				if (alpha == token.begin() + numPos)
+					throw make_exception("'", token, "' is not a valid temperature system!\n(Expected 'K' (Kelvin), 'C' (Celcius), or 'F' (Fahrenheit))");
+				set_system(token, *alpha);
+				if (numPos < token.size()) {
+					if (inputValue.has_value())
+						throw make_exception("Expected a temperature system instead of '", token, "'!");
+					T value;
+					if (numPos + parse_value(token.substr(numPos), token, value) != token.size())
+						throw make_exception("'", token, "' is not a valid number!");
+					inputValue = value;
+				}
 			}
-			else {
-				const auto sys{ getTemperatureSystem(str::toupper(it->at(0ull))) };
 
-				if (sys == 0) // ERROR ; Expected a valid temperature system
-					throw make_exception("'", *it, "' is not a valid temperature system!\n(Expected 'K' (Kelvin), 'C' (Celcius), or 'F' (Fahrenheit))");
+			if (inputSystem == TemperatureSystem::Kelvin && inputValue.has_value() && inputValue.value() < 0) // ERROR ; Kelvin temps cannot be negative
+				throw make_exception("'", token, "' is not a valid Kelvin temperature value because it is negative! (0 Kelvin == Absolute Zero)");
+		}
 
-				vec.emplace_back(TempConversion<T>{ input_temp.value(), sys });
-				input_temp = std::nullopt;
-			}
+		/// @brief	Returns true when a partial input temperature has been consumed, but its conversion hasn't been emitted yet.
+		bool pending() const noexcept
+		{
+			return inputSystem.has_value() || inputValue.has_value();
 		}
+	};
+
+	template<typename T> requires std::floating_point<T> || std::integral<T>
+	std::vector<TempConversion<T>> temperature_parse_arguments(std::vector<std::string> const& arguments)
+	{
+		std::vector<TempConversion<T>> vec;
+		vec.reserve(arguments.size() / 2);
+
+		TemperatureScanner<T> scanner;
+		for (const auto& it : arguments)
+			scanner.feed(it, [&vec](TempConversion<T> const& conversion) { vec.emplace_back(conversion); });
 
-		vec.shrink_to_fit();
 		return vec;
 	}
 }
@@ -0,0 +1,525 @@
+/**
+ * @file	units.hpp
+ * @author	radj307
+ * @brief	A table-driven unit engine. Every unit of every dimension is one row in a single table, & SI or binary prefixes are applied during lookup.
+ */
+#pragma once
+#include "metric.hpp"
+#include "affine.hpp"
+#include "length.hpp"
+#include "data.hpp"
+
+#include <make_exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace conv::units {
+	enum class Dimension : unsigned char {
+		Length,
+		Data,
+		Temperature,
+		Mass,
+		Volume,
+		Time,
+		Pressure,
+		Energy,
+		Speed,
+		Force,
+		Power,
+		DataRate,
+		Frequency,
+	};
+
+	/// @brief	Returns the name of the given dimension.
+	inline constexpr std::string_view dimension_name(Dimension const dimension) noexcept
+	{
+		switch (dimension) {
+		case Dimension::Length:
+			return "length";
+		case Dimension::Data:
+			return "data";
+		case Dimension::Temperature:
+			return "temperature";
+		case Dimension::Mass:
+			return "mass";
+		case Dimension::Volume:
+			return "volume";
+		case Dimension::Time:
+			return "time";
+		case Dimension::Pressure:
+			return "pressure";
+		case Dimension::Energy:
+			return "energy";
+		case Dimension::Speed:
+			return "speed";
+		case Dimension::Force:
+			return "force";
+		case Dimension::Power:
+			return "power";
+		case Dimension::DataRate:
+			return "data rate";
+		case Dimension::Frequency:
+			return "frequency";
+		default:
+			return "?";
+		}
+	}
+
+	/**
+	 * @struct	Dimensions
+	 * @brief	The exponents of the base dimensions (length, mass, time, data, & temperature) that a unit is made of.
+	 *\n		Units can only be converted to units with the same dimensions.
+	 */
+	struct Dimensions {
+		static constexpr std::array<std::string_view, 5ull> NAMES{ "length", "mass", "time", "data", "temperature" };
+
+		std::array<std::int8_t, 5ull> exponents{};
+
+		constexpr bool operator==(Dimensions const&) const noexcept = default;
+
+		/// @brief	Returns the dimensions of the product of a unit with these dimensions, & a unit with the given dimensions raised to the given power.
+		constexpr Dimensions combine(Dimensions const& o, int const power) const noexcept
+		{
+			Dimensions result{ *this };
+			for (size_t i{ 0ull }; i < exponents.size(); ++i)
+				result.exponents[i] = static_cast<std::int8_t>(exponents[i] + o.exponents[i] * power);
+			return result;
+		}
+	};
+
+	/// @brief	Returns the base dimensions of the given dimension.
+	inline constexpr Dimensions dimensions_of(Dimension const dimension) noexcept
+	{
+		// { length, mass, time, data, temperature }
+		switch (dimension) {
+		case Dimension::Length:
+			return{ { 1, 0, 0, 0, 0 } };
+		case Dimension::Data:
+			return{ { 0, 0, 0, 1, 0 } };
+		case Dimension::Temperature:
+			return{ { 0, 0, 0, 0, 1 } };
+		case Dimension::Mass:
+			return{ { 0, 1, 0, 0, 0 } };
+		case Dimension::Volume:
+			return{ { 3, 0, 0, 0, 0 } };
+		case Dimension::Time:
+			return{ { 0, 0, 1, 0, 0 } };
+		case Dimension::Pressure:
+			return{ { -1, 1, -2, 0, 0 } };
+		case Dimension::Energy:
+			return{ { 2, 1, -2, 0, 0 } };
+		case Dimension::Speed:
+			return{ { 1, 0, -1, 0, 0 } };
+		case Dimension::Force:
+			return{ { 1, 1, -2, 0, 0 } };
+		case Dimension::Power:
+			return{ { 2, 1, -3, 0, 0 } };
+		case Dimension::DataRate:
+			return{ { 0, 0, -1, 1, 0 } };
+		case Dimension::Frequency:
+			return{ { 0, 0, -1, 0, 0 } };
+		default:
+			return{};
+		}
+	}
+
+	/// @brief	Returns the name of the given dimensions, ex: "speed", or "length^2/time" when they aren't a named dimension.
+	inline std::string dimensions_name(Dimensions const& dimensions)
+	{
+		for (unsigned char d{ 0 }; d <= static_cast<unsigned char>(Dimension::Frequency); ++d)
+			if (dimensions_of(static_cast<Dimension>(d)) == dimensions)
+				return std::string{ dimension_name(static_cast<Dimension>(d)) };
+		std::string numerator, denominator;
+		for (size_t i{ 0ull }; i < dimensions.exponents.size(); ++i) {
+			if (const int exponent{ dimensions.exponents[i] }; exponent != 0) {
+				std::string& s{ exponent > 0 ? numerator : denominator };
+				if (!s.empty())
+					s += '*';
+				s.append(Dimensions::NAMES[i]);
+				if (exponent != 1 && exponent != -1)
+					s.append("^").append(std::to_string(exponent > 0 ? exponent : -exponent));
+			}
+		}
+		if (numerator.empty())
+			numerator = denominator.empty() ? "dimensionless" : "1";
+		return denominator.empty() ? numerator : numerator + '/' + denominator;
+	}
+
+	/// @brief	The prefixes that a unit accepts.
+	enum class Prefixes : unsigned char {
+		None,
+		// @brief	SI prefixes. (km, ms, kPa)
+		SI,
+		// @brief	Powers of 1024, written with SI or IEC prefix symbols in any case. (kB, KB, KiB, MB)
+		Binary,
+	};
+
+	/**
+	 * @struct	Prefix
+	 * @brief	A unit prefix, & the factor that it multiplies units by.
+	 */
+	struct Prefix {
+		long double factor;
+		std::string_view symbol;
+		// @brief	The prefix's lowercase name.
+		std::string_view name;
+	};
+
+	namespace detail {
+		inline constexpr long double pow(long double const base, int const exponent) noexcept
+		{
+			long double result{ 1.0L };
+			for (int i{ 0 }; i < (exponent < 0 ? -exponent : exponent); ++i)
+				result *= base;
+			return exponent < 0 ? 1.0L / result : result;
+		}
+		inline constexpr Prefix si(metric::Prefix const prefix, std::string_view const symbol, std::string_view const name) noexcept
+		{
+			return{ pow(10.0L, static_cast<int>(prefix)), symbol, name };
+		}
+		inline constexpr Prefix binary(int const power, std::string_view const symbol, std::string_view const name) noexcept
+		{
+			return{ pow(data::UNIT_RATIO, power), symbol, name };
+		}
+
+		inline constexpr char tolower(char const c) noexcept { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c; }
+		/// @brief	Returns true when the given strings are equal, ignoring the case of ASCII letters.
+		inline constexpr bool iequals(std::string_view const l, std::string_view const r) noexcept
+		{
+			return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin(), [](char const a, char const b) { return tolower(a) == tolower(b); });
+		}
+	}
+
+	// the two-character prefixes come first, so that "dam" is decameters
+	inline constexpr std::array SI_PREFIXES{
+		detail::si(metric::Prefix::DECA, "da", "deca"),
+		detail::si(metric::Prefix::MICRO, "µ", "micro"),	// micro sign
+		detail::si(metric::Prefix::MICRO, "μ", "micro"),	// greek mu
+		detail::si(metric::Prefix::QUECTO, "q", "quecto"),
+		detail::si(metric::Prefix::RONTO, "r", "ronto"),
+		detail::si(metric::Prefix::YOCTO, "y", "yocto"),
+		detail::si(metric::Prefix::ZEPTO, "z", "zepto"),
+		detail::si(metric::Prefix::ATTO, "a", "atto"),
+		detail::si(metric::Prefix::FEMTO, "f", "femto"),
+		detail::si(metric::Prefix::PICO, "p", "pico"),
+		detail::si(metric::Prefix::NANO, "n", "nano"),
+		detail::si(metric::Prefix::MICRO, "u", "micro"),
+		detail::si(metric::Prefix::MILLI, "m", "milli"),
+		detail::si(metric::Prefix::CENTI, "c", "centi"),
+		detail::si(metric::Prefix::DECI, "d", "deci"),
+		detail::si(metric::Prefix::HECTO, "h", "hecto"),
+		detail::si(metric::Prefix::KILO, "k", "kilo"),
+		detail::si(metric::Prefix::MEGA, "M", "mega"),
+		detail::si(metric::Prefix::GIGA, "G", "giga"),
+		detail::si(metric::Prefix::TERA, "T", "tera"),
+		detail::si(metric::Prefix::PETA, "P", "peta"),
+		detail::si(metric::Prefix::EXA, "E", "exa"),
+		detail::si(metric::Prefix::ZETTA, "Z", "zetta"),
+		detail::si(metric::Prefix::YOTTA, "Y", "yotta"),
+		detail::si(metric::Prefix::RONNA, "R", "ronna"),
+		detail::si(metric::Prefix::QUETTA, "Q", "quetta"),
+	};
+	// the IEC prefixes come first, since their symbols begin with the SI symbol
+	inline constexpr std::array BINARY_PREFIXES{
+		detail::binary(1, "Ki", "kibi"), detail::binary(1, "k", "kilo"),
+		detail::binary(2, "Mi", "mebi"), detail::binary(2, "M", "mega"),
+		detail::binary(3, "Gi", "gibi"), detail::binary(3, "G", "giga"),
+		detail::binary(4, "Ti", "tebi"), detail::binary(4, "T", "tera"),
+		detail::binary(5, "Pi", "pebi"), detail::binary(5, "P", "peta"),
+		detail::binary(6, "Ei", "exbi"), detail::binary(6, "E", "exa"),
+		detail::binary(7, "Zi", "zebi"), detail::binary(7, "Z", "zetta"),
+		detail::binary(8, "Yi", "yobi"), detail::binary(8, "Y", "yotta"),
+	};
+
+	/**
+	 * @struct	Definition
+	 * @brief	One row of the unit table.
+	 */
+	struct Definition {
+		Dimension dimension;
+		// @brief	The unit's symbols, which are case-sensitive. The first one is displayed. Unused symbols are empty.
+		std::array<std::string_view, 3ull> symbols;
+		// @brief	The unit's lowercase names, spellings, & plurals, which are case-insensitive. Unused names are empty.
+		std::array<std::string_view, 4ull> names;
+		// @brief	The transform that converts values in this unit to the base unit of its dimension.
+		affine toBase;
+		Prefixes prefixes{ Prefixes::None };
+	};
+
+	/**
+	 * @brief	The unit table. Every unit converts to the SI unit of its dimensions; (meters, kilograms, seconds, kelvin) data sizes convert to bytes.
+	 *\n		Lengths use the factors from length.hpp, & data sizes use the ratio from data.hpp, so that every mode agrees.
+	 */
+	inline constexpr std::array UNITS{
+		// LENGTH
+		Definition{ Dimension::Length, { "m" }, { "meter", "meters", "metre", "metres" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Length, { "in", "\"" }, { "inch", "inches" }, { length::ONE_FOOT_IN_METERS * length::imperial::INCH, 0.0L } },
+		Definition{ Dimension::Length, { "ft", "'" }, { "foot", "feet" }, { length::ONE_FOOT_IN_METERS * length::imperial::FOOT, 0.0L } },
+		Definition{ Dimension::Length, { "yd" }, { "yard", "yards" }, { length::ONE_FOOT_IN_METERS * length::imperial::YARD, 0.0L } },
+		Definition{ Dimension::Length, { "mi" }, { "mile", "miles" }, { length::ONE_FOOT_IN_METERS * length::imperial::MILE, 0.0L } },
+		Definition{ Dimension::Length, { "nmi" }, { "nauticalmile", "nauticalmiles" }, { length::ONE_FOOT_IN_METERS * length::imperial::NAUTICAL_MILE, 0.0L } },
+		Definition{ Dimension::Length, { "twip" }, { "twip", "twips" }, { length::ONE_FOOT_IN_METERS * length::imperial::TWIP, 0.0L } },
+		Definition{ Dimension::Length, { "th" }, { "thou", "thous" }, { length::ONE_FOOT_IN_METERS * length::imperial::THOU, 0.0L } },
+		Definition{ Dimension::Length, { "Bc" }, { "barleycorn", "barleycorns" }, { length::ONE_FOOT_IN_METERS * length::imperial::BARLEYCORN, 0.0L } },
+		Definition{ Dimension::Length, { "hand" }, { "hand", "hands" }, { length::ONE_FOOT_IN_METERS * length::imperial::HAND, 0.0L } },
+		Definition{ Dimension::Length, { "ch" }, { "chain", "chains" }, { length::ONE_FOOT_IN_METERS * length::imperial::CHAIN, 0.0L } },
+		Definition{ Dimension::Length, { "fur" }, { "furlong", "furlongs" }, { length::ONE_FOOT_IN_METERS * length::imperial::FURLONG, 0.0L } },
+		Definition{ Dimension::Length, { "lea" }, { "league", "leagues" }, { length::ONE_FOOT_IN_METERS * length::imperial::LEAGUE, 0.0L } },
+		Definition{ Dimension::Length, { "ftm" }, { "fathom", "fathoms" }, { length::ONE_FOOT_IN_METERS * length::imperial::FATHOM, 0.0L } },
+		Definition{ Dimension::Length, { "cable" }, { "cable", "cables" }, { length::ONE_FOOT_IN_METERS * length::imperial::CABLE, 0.0L } },
+		Definition{ Dimension::Length, { "link" }, { "link", "links" }, { length::ONE_FOOT_IN_METERS * length::imperial::LINK, 0.0L } },
+		Definition{ Dimension::Length, { "rd" }, { "rod", "rods" }, { length::ONE_FOOT_IN_METERS * length::imperial::ROD, 0.0L } },
+		Definition{ Dimension::Length, { "u" }, {}, { length::ONE_UNIT_IN_METERS, 0.0L }, Prefixes::SI }, // Bethesda creation kit units; a table has one factor per unit, so unlike -l, these convert to imperial units through meters instead of using ONE_UNIT_IN_FEET
+		// DATA
+		Definition{ Dimension::Data, { "B" }, { "byte", "bytes" }, { 1.0L, 0.0L }, Prefixes::Binary },
+		Definition{ Dimension::Data, { "bit" }, { "bit", "bits" }, { 0.125L, 0.0L }, Prefixes::SI },
+		// TEMPERATURE
+		Definition{ Dimension::Temperature, { "K", "°K" }, { "kelvin", "kelvins" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Temperature, { "°C", "C", "℃" }, { "celsius", "celcius" }, { 1.0L, 273.15L } },
+		Definition{ Dimension::Temperature, { "°F", "F", "℉" }, { "fahrenheit" }, { 1.0L / 1.8L, 273.15L - 32.0L / 1.8L } },
+		Definition{ Dimension::Temperature, { "°R", "°Ra" }, { "rankine" }, { 1.0L / 1.8L, 0.0L } },
+		// MASS
+		Definition{ Dimension::Mass, { "g" }, { "gram", "grams", "gramme", "grammes" }, { 0.001L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Mass, { "t" }, { "tonne", "tonnes" }, { 1000.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Mass, { "lb", "lbs" }, { "pound", "pounds" }, { 0.45359237L, 0.0L } },
+		Definition{ Dimension::Mass, { "oz" }, { "ounce", "ounces" }, { 0.45359237L / 16.0L, 0.0L } },
+		Definition{ Dimension::Mass, { "st" }, { "stone", "stones" }, { 0.45359237L * 14.0L, 0.0L } },
+		Definition{ Dimension::Mass, { "gr" }, { "grain", "grains" }, { 0.45359237L / 7000.0L, 0.0L } },
+		Definition{ Dimension::Mass, { "ton" }, { "ton", "tons" }, { 0.45359237L * 2000.0L, 0.0L } },
+		// VOLUME
+		Definition{ Dimension::Volume, { "L", "l", "ℓ" }, { "liter", "liters", "litre", "litres" }, { 0.001L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Volume, { "m3", "m³" }, { "cubicmeter", "cubicmeters", "cubicmetre", "cubicmetres" }, { 1.0L, 0.0L } },
+		Definition{ Dimension::Volume, { "cm3", "cm³", "cc" }, { "cubiccentimeter", "cubiccentimeters", "cubiccentimetre", "cubiccentimetres" }, { 1e-6L, 0.0L } },
+		Definition{ Dimension::Volume, { "mm3", "mm³" }, { "cubicmillimeter", "cubicmillimeters", "cubicmillimetre", "cubicmillimetres" }, { 1e-9L, 0.0L } },
+		Definition{ Dimension::Volume, { "km3", "km³" }, { "cubickilometer", "cubickilometers", "cubickilometre", "cubickilometres" }, { 1e9L, 0.0L } },
+		Definition{ Dimension::Volume, { "in3", "in³" }, { "cubicinch", "cubicinches" }, { 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		Definition{ Dimension::Volume, { "ft3", "ft³" }, { "cubicfoot", "cubicfeet" }, { 0.3048L * 0.3048L * 0.3048L, 0.0L } },
+		Definition{ Dimension::Volume, { "gal" }, { "gallon", "gallons" }, { 231.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },	// US
+		Definition{ Dimension::Volume, { "qt" }, { "quart", "quarts" }, { 231.0L / 4.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		Definition{ Dimension::Volume, { "pt" }, { "pint", "pints" }, { 231.0L / 8.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		Definition{ Dimension::Volume, { "cup" }, { "cup", "cups" }, { 231.0L / 16.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		Definition{ Dimension::Volume, { "floz", "fl.oz" }, { "fluidounce", "fluidounces" }, { 231.0L / 128.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		Definition{ Dimension::Volume, { "tbsp" }, { "tablespoon", "tablespoons" }, { 231.0L / 256.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		Definition{ Dimension::Volume, { "tsp" }, { "teaspoon", "teaspoons" }, { 231.0L / 768.0L * 0.0254L * 0.0254L * 0.0254L, 0.0L } },
+		// TIME
+		Definition{ Dimension::Time, { "s", "sec", "secs" }, { "second", "seconds" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Time, { "min", "mins" }, { "minute", "minutes" }, { 60.0L, 0.0L } },
+		Definition{ Dimension::Time, { "h", "hr", "hrs" }, { "hour", "hours" }, { 3600.0L, 0.0L } },
+		Definition{ Dimension::Time, { "d" }, { "day", "days" }, { 86400.0L, 0.0L } },
+		Definition{ Dimension::Time, { "wk" }, { "week", "weeks" }, { 604800.0L, 0.0L } },
+		Definition{ Dimension::Time, { "yr" }, { "year", "years" }, { 31557600.0L, 0.0L } },	// julian
+		// PRESSURE
+		Definition{ Dimension::Pressure, { "Pa" }, { "pascal", "pascals" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Pressure, { "bar" }, { "bar", "bars" }, { 100000.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Pressure, { "atm" }, { "atmosphere", "atmospheres" }, { 101325.0L, 0.0L } },
+		Definition{ Dimension::Pressure, { "Torr", "torr" }, { "torr" }, { 101325.0L / 760.0L, 0.0L } },
+		Definition{ Dimension::Pressure, { "mmHg" }, {}, { 133.322387415L, 0.0L } },
+		Definition{ Dimension::Pressure, { "inHg" }, {}, { 3386.389L, 0.0L } },
+		Definition{ Dimension::Pressure, { "psi" }, {}, { 0.45359237L * 9.80665L / (0.0254L * 0.0254L), 0.0L } },
+		// ENERGY
+		Definition{ Dimension::Energy, { "J" }, { "joule", "joules" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Energy, { "Wh" }, { "watthour", "watthours" }, { 3600.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Energy, { "cal" }, { "calorie", "calories" }, { 4.184L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Energy, { "eV" }, { "electronvolt", "electronvolts" }, { 1.602176634e-19L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Energy, { "BTU", "Btu" }, { "btu", "btus" }, { 1055.05585262L, 0.0L } },
+		// SPEED
+		Definition{ Dimension::Speed, { "mph" }, { "milesperhour" }, { 0.3048L * 5280.0L / 3600.0L, 0.0L } },
+		Definition{ Dimension::Speed, { "kph" }, { "kilometersperhour", "kilometresperhour" }, { 1000.0L / 3600.0L, 0.0L } },
+		Definition{ Dimension::Speed, { "kn" }, { "knot", "knots" }, { 0.3048L * 6076.1L / 3600.0L, 0.0L } },
+		// FORCE
+		Definition{ Dimension::Force, { "N" }, { "newton", "newtons" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Force, { "lbf" }, { "poundforce" }, { 0.45359237L * 9.80665L, 0.0L } },
+		Definition{ Dimension::Force, { "kgf" }, { "kilogramforce" }, { 9.80665L, 0.0L } },
+		Definition{ Dimension::Force, { "dyn" }, { "dyne", "dynes" }, { 1e-5L, 0.0L } },
+		// POWER
+		Definition{ Dimension::Power, { "W" }, { "watt", "watts" }, { 1.0L, 0.0L }, Prefixes::SI },
+		Definition{ Dimension::Power, { "hp" }, { "horsepower" }, { 0.45359237L * 9.80665L * 0.3048L * 550.0L, 0.0L } },	// mechanical
+		// DATA RATE
+		Definition{ Dimension::DataRate, { "bps" }, {}, { 0.125L, 0.0L }, Prefixes::SI },
+		// FREQUENCY
+		Definition{ Dimension::Frequency, { "Hz" }, { "hertz" }, { 1.0L, 0.0L }, Prefixes::SI },
+	};
+
+	namespace detail {
+		/// @brief	An entry in a lookup index.
+		struct Key {
+			std::string_view key;
+			unsigned short unit;
+		};
+
+		template<bool Names>
+		inline constexpr size_t count_keys() noexcept
+		{
+			size_t count{ 0ull };
+			for (const auto& unit : UNITS) {
+				if constexpr (Names)
+					count += static_cast<size_t>(std::count_if(unit.names.begin(), unit.names.end(), [](auto&& name) { return !name.empty(); }));
+				else count += static_cast<size_t>(std::count_if(unit.symbols.begin(), unit.symbols.end(), [](auto&& symbol) { return !symbol.empty(); }));
+			}
+			return count;
+		}
+
+		/// @brief	Builds a sorted index of every symbol, or every name, in the unit table.
+		template<bool Names>
+		inline constexpr auto make_index() noexcept
+		{
+			std::array<Key, count_keys<Names>()> index{};
+			size_t i{ 0ull };
+			for (unsigned short u{ 0 }; u < UNITS.size(); ++u) {
+				for (const auto& key : Names ? std::span<const std::string_view>{ UNITS[u].names } : std::span<const std::string_view>{ UNITS[u].symbols })
+					if (!key.empty())
+						index[i++] = { key, u };
+			}
+			std::sort(index.begin(), index.end(), [](Key const& l, Key const& r) { return l.key < r.key; });
+			return index;
+		}
+
+		inline constexpr auto SYMBOL_INDEX{ make_index<false>() };
+		inline constexpr auto NAME_INDEX{ make_index<true>() };
+
+		/// @brief	Returns the entry with the given key, or nullptr.
+		template<size_t N>
+		inline constexpr const Key* lookup(std::array<Key, N> const& index, std::string_view const key) noexcept
+		{
+			const auto& it{ std::lower_bound(index.begin(), index.end(), key, [](Key const& l, std::string_view const r) { return l.key < r; }) };
+			return (it == index.end() || it->key != key) ? nullptr : &*it;
+		}
+	}
+
+	/**
+	 * @struct	Unit
+	 * @brief	A unit from the table, & its prefix.
+	 */
+	struct Unit {
+		Definition const* definition{ nullptr };
+		// @brief	The unit's prefix, or nullptr when it doesn't have one.
+		Prefix const* prefix{ nullptr };
+
+		constexpr Dimension dimension() const noexcept { return definition->dimension; }
+		constexpr Dimensions dimensions() const noexcept { return dimensions_of(definition->dimension); }
+
+		/// @brief	Returns the transform that converts values in this unit to the base unit of its dimension.
+		constexpr affine to_base() const noexcept
+		{
+			return{ definition->toBase.scale * (prefix == nullptr ? 1.0L : prefix->factor), definition->toBase.offset };
+		}
+		/// @brief	Returns the transform that converts values in this unit to the given unit.
+		affine to(Unit const& target) const
+		{
+			if (target.dimension() != dimension())
+				throw make_exception("Can't convert ", dimension_name(dimension()), " unit \"", symbol(), "\" to ", dimension_name(target.dimension()), " unit \"", target.symbol(), "\"!");
+			const affine& out{ target.to_base() };
+			return to_base().then({ 1.0L / out.scale, -out.offset / out.scale });
+		}
+
+		/// @brief	Returns the unit's symbol, including its prefix.
+		std::string symbol() const { return std::string{ prefix == nullptr ? std::string_view{} : prefix->symbol }.append(definition->symbols[0]); }
+		/// @brief	Returns the text printed after values in this unit, including any separator.
+		std::string suffix() const { return (definition->symbols[0].starts_with("°") ? "" : " ") + symbol(); }
+	};
+
+	/**
+	 * @brief		Finds a unit by its symbol or name, with or without a prefix. Symbols are case-sensitive, except that binary prefixes
+	 *\n			 & the units they apply to may be written in any case. ("KB", "kb") Names are case-insensitive.
+	 * @param s		Input string, ex: "km", "kilometers", "MiB", "°F".
+	 * @returns		The unit, or std::nullopt if the string isn't a unit.
+	 */
+	inline constexpr std::optional<Unit> find(std::string_view const s) noexcept
+	{
+		constexpr size_t MAX_LENGTH{ 64ull };
+		if (s.empty() || s.size() > MAX_LENGTH)
+			return std::nullopt;
+		if (const auto* key{ detail::lookup(detail::SYMBOL_INDEX, s) })
+			return Unit{ &UNITS[key->unit] };
+
+		char buffer[MAX_LENGTH]{};
+		std::transform(s.begin(), s.end(), buffer, detail::tolower);
+		const std::string_view lower{ buffer, s.size() };
+		if (const auto* key{ detail::lookup(detail::NAME_INDEX, lower) })
+			return Unit{ &UNITS[key->unit] };
+
+		// prefixed symbols
+		for (const auto& prefix : SI_PREFIXES) {
+			if (s.size() > prefix.symbol.size() && s.starts_with(prefix.symbol))
+				if (const auto* key{ detail::lookup(detail::SYMBOL_INDEX, s.substr(prefix.symbol.size())) }; key != nullptr && UNITS[key->unit].prefixes == Prefixes::SI)
+					return Unit{ &UNITS[key->unit], &prefix };
+		}
+		for (const auto& prefix : BINARY_PREFIXES) {
+			if (s.size() > prefix.symbol.size() && detail::iequals(s.substr(0ull, prefix.symbol.size()), prefix.symbol))
+				for (const auto& unit : UNITS)
+					if (unit.prefixes == Prefixes::Binary && std::any_of(unit.symbols.begin(), unit.symbols.end(), [&](auto&& symbol) { return !symbol.empty() && detail::iequals(s.substr(prefix.symbol.size()), symbol); }))
+						return Unit{ &unit, &prefix };
+		}
+
+		// prefixed names
+		for (const auto& [prefixes, table] : { std::pair{ Prefixes::SI, std::span<const Prefix>{ SI_PREFIXES } }, std::pair{ Prefixes::Binary, std::span<const Prefix>{ BINARY_PREFIXES } } }) {
+			for (const auto& prefix : table) {
+				if (lower.size() > prefix.name.size() && lower.starts_with(prefix.name))
+					if (const auto* key{ detail::lookup(detail::NAME_INDEX, lower.substr(prefix.name.size())) }; key != nullptr && UNITS[key->unit].prefixes == prefixes)
+						return Unit{ &UNITS[key->unit], &prefix };
+			}
+		}
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief		Finds a unit by its symbol or name.
+	 * @param s		Input string.
+	 * @returns		The unit.
+	 * @throws		ex::except when the string isn't a unit.
+	 */
+	inline Unit get(std::string_view const s)
+	{
+		if (const auto& unit{ find(s) }; unit.has_value())
+			return unit.value();
+		throw make_exception("Unrecognized unit: \"", s, "\"!");
+	}
+
+	/**
+	 * @brief		Calls the given function with every key that find() accepts exactly as written, & the unit it finds.
+	 *\n			Binary-prefixed symbols are listed as written in the table, in uppercase, & in lowercase.
+	 * @param func	A function that accepts a std::string const& key & a Unit.
+	 */
+	template<typename TFunc>
+	inline void for_each_key(TFunc&& func)
+	{
+		for (const auto& unit : UNITS) {
+			const auto& each_prefix{ [&](Prefix const* prefix, bool const names) {
+				const std::string_view prefixSymbol{ prefix == nullptr ? std::string_view{} : prefix->symbol }, prefixName{ prefix == nullptr ? std::string_view{} : prefix->name };
+				for (const auto& symbol : unit.symbols) {
+					if (symbol.empty())
+						continue;
+					const std::string key{ std::string{ prefixSymbol }.append(symbol) };
+					func(key, Unit{ &unit, prefix });
+					if (prefix != nullptr && unit.prefixes == Prefixes::Binary) {
+						std::string upper{ key }, lower{ key };
+						std::transform(key.begin(), key.end(), upper.begin(), [](char const c) { return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c; });
+						std::transform(key.begin(), key.end(), lower.begin(), detail::tolower);
+						if (upper != key)
+							func(upper, Unit{ &unit, prefix });
+						if (lower != key && lower != upper)
+							func(lower, Unit{ &unit, prefix });
+					}
+				}
+				if (names) for (const auto& name : unit.names)
+					if (!name.empty())
+						func(std::string{ prefixName }.append(name), Unit{ &unit, prefix });
+			} };
+			each_prefix(nullptr, true);
+			if (unit.prefixes == Prefixes::SI) {
+				for (const auto& prefix : SI_PREFIXES) // the alternate micro symbols would repeat every name
+					each_prefix(&prefix, prefix.symbol != "μ" && prefix.symbol != "u");
+			}
+			else if (unit.prefixes == Prefixes::Binary) {
+				for (const auto& prefix : BINARY_PREFIXES)
+					each_prefix(&prefix, true);
+			}
+		}
+	}
+}
@@ -0,0 +1,127 @@
+/**
+ * @file	wideint.hpp
+ * @author	radj307
+ * @brief	Portable 64x64 => 128-bit multiplication & 128 / 64-bit division helpers.
+ */
+#pragma once
+#include <cstdint>
+
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace wideint {
+	using u64 = std::uint64_t;
+
+	/**
+	 * @struct	u128
+	 * @brief	Unsigned 128-bit value, split into two 64-bit halves.
+	 */
+	struct u128 {
+		u64 lo, hi;
+	};
+
+	/**
+	 * @brief	Full 64x64 => 128-bit unsigned multiplication.
+	 * @returns	u128
+	 */
+	inline u128 mul(u64 const a, u64 const b) noexcept
+	{
+	#if defined(__SIZEOF_INT128__)
+		const unsigned __int128 p{ static_cast<unsigned __int128>(a) * b };
+		return{ static_cast<u64>(p), static_cast<u64>(p >> 64) };
+	#elif defined(_MSC_VER) && defined(_M_X64)
+		u64 hi;
+		const u64 lo{ _umul128(a, b, &hi) };
+		return{ lo, hi };
+	#else
+		const u64 a_lo{ a & 0xFFFFFFFFull }, a_hi{ a >> 32 }, b_lo{ b & 0xFFFFFFFFull }, b_hi{ b >> 32 };
+		const u64 ll{ a_lo * b_lo }, lh{ a_lo * b_hi }, hl{ a_hi * b_lo }, hh{ a_hi * b_hi };
+		const u64 mid{ (ll >> 32) + (lh & 0xFFFFFFFFull) + (hl & 0xFFFFFFFFull) };
+		return{ (mid << 32) | (ll & 0xFFFFFFFFull), hh + (lh >> 32) + (hl >> 32) + (mid >> 32) };
+	#endif
+	}
+
+	/// @brief	Returns the high 64 bits of the 128-bit product of a & b.
+	inline u64 mulhi(u64 const a, u64 const b) noexcept
+	{
+		return mul(a, b).hi;
+	}
+
+	/**
+	 * @brief		Divide a 128-bit number by a 64-bit divisor. The high half of n must be less than d,
+	 *\n			so that the quotient fits in 64 bits.
+	 * @param n		Dividend.
+	 * @param d		Divisor. Must not be zero.
+	 * @param rem	Receives the remainder.
+	 * @returns		The quotient.
+	 */
+	inline u64 div(u128 const n, u64 const d, u64& rem) noexcept
+	{
+	#if defined(__SIZEOF_INT128__)
+		const unsigned __int128 num{ (static_cast<unsigned __int128>(n.hi) << 64) | n.lo };
+		rem = static_cast<u64>(num % d);
+		return static_cast<u64>(num / d);
+	#elif defined(_MSC_VER) && defined(_M_X64) && _MSC_VER >= 1920
+		return _udiv128(n.hi, n.lo, d, &rem);
+	#else
+		// restoring binary long division
+		u64 r{ n.hi }, q{ 0 };
+		for (int i{ 63 }; i >= 0; --i) {
+			const bool carry{ (r >> 63) != 0 };
+			r = (r << 1) | ((n.lo >> i) & 1ull);
+			q <<= 1;
+			if (carry || r >= d) {
+				r -= d;
+				q |= 1ull;
+			}
+		}
+		rem = r;
+		return q;
+	#endif
+	}
+
+	/// @brief	Returns (a * b) % m without overflowing.
+	inline u64 mulmod(u64 const a, u64 const b, u64 const m) noexcept
+	{
+		auto p{ mul(a, b) };
+		u64 rem;
+		p.hi %= m; // keeps the quotient within 64 bits without changing the remainder
+		div(p, m, rem);
+		return rem;
+	}
+
+	/**
+	 * @brief	Returns the multiplicative inverse of an odd number modulo 2^64, using Newton's iteration.
+	 */
+	inline constexpr u64 inverse(u64 const odd) noexcept
+	{
+		u64 inv{ odd }; // correct to 3 bits, since odd * odd == 1 (mod 8)
+		for (int i{ 0 }; i < 5; ++i) // each step doubles the number of correct bits
+			inv *= 2ull - odd * inv;
+		return inv;
+	}
+
+	/// @brief	Returns the number of leading zero bits in v. Returns 64 when v is zero.
+	inline constexpr int clz(u64 v) noexcept
+	{
+		if (v == 0)
+			return 64;
+		int n{ 0 };
+		if ((v >> 32) == 0) n += 32, v <<= 32;
+		if ((v >> 48) == 0) n += 16, v <<= 16;
+		if ((v >> 56) == 0) n += 8, v <<= 8;
+		if ((v >> 60) == 0) n += 4, v <<= 4;
+		if ((v >> 62) == 0) n += 2, v <<= 2;
+		if ((v >> 63) == 0) n += 1;
+		return n;
+	}
+
+	/// @brief	Returns the number of trailing zero bits in v. Returns 64 when v is zero.
+	inline constexpr int ctz(u64 const v) noexcept
+	{
+		if (v == 0)
+			return 64;
+		return 63 - clz(v & (0ull - v));
+	}
+}